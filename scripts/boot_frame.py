@@ -0,0 +1,83 @@
+# Sinh src/boot_frame_data.h: frame đầu của video01 giải mã sẵn sang RGB565
+# (big-endian, đúng thứ tự byte gửi qua SPI) để đẩy thẳng lên màn hình lúc
+# khởi động, không cần TJpgDec.
+#
+# PlatformIO:   extra_scripts = pre:scripts/boot_frame.py
+# Chạy tay:     python scripts/boot_frame.py
+#
+# Cần Pillow (pip install pillow). Thiếu Pillow thì bỏ qua: firmware vẫn
+# build, chỉ không có frame khởi động nhanh.
+
+import io
+import os
+import re
+import sys
+
+SOURCE = "video01.h"
+SYMBOL = "video01_jpg_frame_0"
+OUTPUT = "boot_frame_data.h"
+BYTES_PER_LINE = 16
+
+
+def read_jpeg(path, symbol):
+    with open(path, "r", encoding="utf-8", errors="ignore") as f:
+        text = f.read()
+    m = re.search(re.escape(symbol) + r"\[\][^{]*\{([^}]*)\}", text)
+    if not m:
+        raise ValueError("%s not found in %s" % (symbol, path))
+    return bytes(int(v, 16) for v in re.findall(r"0x([0-9A-Fa-f]{2})", m.group(1)))
+
+
+def to_rgb565(jpeg):
+    from PIL import Image
+    img = Image.open(io.BytesIO(jpeg)).convert("RGB")
+    raw = img.tobytes()
+    out = bytearray()
+    for i in range(0, len(raw), 3):
+        r, g, b = raw[i], raw[i + 1], raw[i + 2]
+        c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+        out += bytes((c >> 8, c & 0xFF))
+    return img.size, out
+
+
+def write_header(path, size, data):
+    w, h = size
+    lines = [
+        "// Tự sinh bởi scripts/boot_frame.py từ %s (%s), không sửa tay" % (SOURCE, SYMBOL),
+        "#ifndef BOOT_FRAME_DATA_H",
+        "#define BOOT_FRAME_DATA_H",
+        "",
+        "#define BOOT_FRAME_WIDTH %d" % w,
+        "#define BOOT_FRAME_HEIGHT %d" % h,
+        "",
+        "// RGB565 big-endian, %d byte" % len(data),
+        "const uint8_t bootFrame[] PROGMEM __attribute__((aligned(4))) = {",  # pushImage đọc theo uint16_t
+    ]
+    for i in range(0, len(data), BYTES_PER_LINE):
+        lines.append("".join("0x%02X, " % b for b in data[i:i + BYTES_PER_LINE]).rstrip())
+    lines += ["};", "", "#endif", ""]
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines))
+
+
+def generate(src_dir):
+    source = os.path.join(src_dir, SOURCE)
+    output = os.path.join(src_dir, OUTPUT)
+    if os.path.exists(output) and os.path.getmtime(output) >= os.path.getmtime(source):
+        return
+    try:
+        size, data = to_rgb565(read_jpeg(source, SYMBOL))
+    except ImportError:
+        print("boot_frame: Pillow not installed, skipping boot frame")
+        return
+    write_header(output, size, data)
+    print("boot_frame: %s %dx%d (%d bytes)" % (OUTPUT, size[0], size[1], len(data)))
+
+
+try:
+    Import("env")  # noqa: F821 (PlatformIO/SCons)
+    generate(env.subst("$PROJECT_SRC_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        here = os.path.dirname(os.path.abspath(sys.argv[0]))
+        generate(os.path.join(here, "..", "src") if len(sys.argv) < 2 else sys.argv[1])
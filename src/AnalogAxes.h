@@ -0,0 +1,149 @@
+#ifndef ANALOG_AXES_H
+#define ANALOG_AXES_H
+
+#include <Arduino.h>
+#include "driver/adc.h"
+#include "AxisFilter.h"
+
+// Đọc cần/cò analog bằng ADC liên tục: timer của bộ điều khiển ADC số kích
+// chuyển đổi, DMA đổ kết quả vào bộ đệm, CPU chỉ gom theo khung.
+// Mỗi khung: trung bình mọi mẫu của 1 kênh (oversampling) -> AxisFilter.
+// Chỉ dùng ADC1 (ADC2 bị radio chiếm khi bật BLE).
+#define AXIS_MAX 4
+#define AXIS_SAMPLE_HZ 20000        // tổng mọi kênh
+#define AXIS_FRAME_BYTES 256        // 1 lần ngắt DMA
+#define AXIS_REPORT_THRESHOLD 64    // ~0.2% hành trình
+
+#if CONFIG_IDF_TARGET_ESP32
+#define AXIS_RESULT_BYTES 2
+#else
+#define AXIS_RESULT_BYTES 4
+#endif
+
+class AnalogAxes {
+public:
+    // pins: chân ADC1, cal: hiệu chuẩn từng trục. Trả về false nếu ADC không khởi động được.
+    bool begin(const int* pins, const AxisCalibration* cal, uint8_t count) {
+        numAxes = count < AXIS_MAX ? count : AXIS_MAX;
+        uint32_t mask = 0;
+        adc_digi_pattern_config_t pattern[AXIS_MAX];
+        for (uint8_t i = 0; i < numAxes; i++) {
+            int ch = digitalPinToAnalogChannel(pins[i]);
+            if (ch < 0 || ch >= 10) return false;   // ADC2 hoặc không phải chân ADC
+            channel[i] = ch;
+            mask |= 1u << ch;
+            pattern[i].atten = ADC_ATTEN_DB_11;
+            pattern[i].channel = ch;
+            pattern[i].unit = 0;                    // ADC1
+            pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+            filters[i].begin(cal[i]);
+        }
+
+        adc_digi_init_config_t init = {};
+        init.max_store_buf_size = AXIS_FRAME_BYTES * 4;
+        init.conv_num_each_intr = AXIS_FRAME_BYTES;
+        init.adc1_chan_mask = mask;
+        init.adc2_chan_mask = 0;
+        if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+        adc_digi_configuration_t cfg = {};
+#if CONFIG_IDF_TARGET_ESP32
+        // ESP32 (IDF 4.4): bộ điều khiển số bắt buộc giới hạn số lần chuyển đổi
+        // mỗi vòng pattern, thiếu thì configure lỗi hoặc DMA không dừng
+        cfg.conv_limit_en = true;
+        cfg.conv_limit_num = 250;
+#else
+        cfg.conv_limit_en = false;
+#endif
+        cfg.pattern_num = numAxes;
+        cfg.adc_pattern = pattern;
+        cfg.sample_freq_hz = AXIS_SAMPLE_HZ;
+        cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+#if CONFIG_IDF_TARGET_ESP32
+        cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+#else
+        cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+#endif
+        if (adc_digi_controller_configure(&cfg) != ESP_OK || adc_digi_start() != ESP_OK) {
+            adc_digi_deinitialize();
+            return false;
+        }
+        running = true;
+        return true;
+    }
+
+    // Gom các khung DMA đã có (không chờ). Trả về true nếu có trục cần gửi.
+    // Bộ đệm driver tràn (ESP_ERR_INVALID_STATE, loop bị chặn lâu): vẫn lấy hết
+    // dữ liệu đang có rồi khởi động lại chuyển đổi để trục không bị đứng.
+    bool poll() {
+        if (!running) return false;
+        uint8_t buf[AXIS_FRAME_BYTES];
+        bool overflow = false;
+        while (true) {
+            uint32_t got = 0;
+            esp_err_t err = adc_digi_read_bytes(buf, sizeof(buf), &got, 0);
+            if (err == ESP_ERR_INVALID_STATE) overflow = true;
+            else if (err != ESP_OK) break;
+            if (!got) break;
+            frame(buf, got);
+        }
+        if (overflow) {
+            adc_digi_stop();
+            adc_digi_start();
+            numOverflows++;
+        }
+        for (uint8_t i = 0; i < numAxes; i++) {
+            if (filters[i].changed(AXIS_REPORT_THRESHOLD)) return true;
+        }
+        return false;
+    }
+
+    // Lấy vị trí hiện tại làm điểm nghỉ của các cần (gọi sau vài khung lúc khởi động)
+    void calibrateCenter() {
+        for (uint8_t i = 0; i < numAxes; i++) filters[i].calibrateCenter();
+    }
+
+    uint8_t count() const { return numAxes; }
+    int16_t value(uint8_t i) const { return filters[i].value(); }
+    bool changed(uint8_t i) const { return filters[i].changed(AXIS_REPORT_THRESHOLD); }
+    void markReported(uint8_t i) { filters[i].markReported(); }
+    uint32_t frames() const { return numFrames; }
+    uint32_t overflows() const { return numOverflows; }
+
+private:
+    AxisFilter filters[AXIS_MAX];
+    int8_t channel[AXIS_MAX];
+    uint8_t numAxes = 0;
+    bool running = false;
+    uint32_t numFrames = 0;
+    uint32_t numOverflows = 0;
+
+    // Oversampling: cộng dồn mọi mẫu của từng kênh trong khung rồi lấy trung bình
+    void frame(const uint8_t* buf, uint32_t len) {
+        uint32_t sum[AXIS_MAX] = {0};
+        uint16_t n[AXIS_MAX] = {0};
+        for (uint32_t off = 0; off + AXIS_RESULT_BYTES <= len; off += AXIS_RESULT_BYTES) {
+            const adc_digi_output_data_t* d = (const adc_digi_output_data_t*)&buf[off];
+#if CONFIG_IDF_TARGET_ESP32
+            uint8_t ch = d->type1.channel;
+            uint16_t v = d->type1.data;
+#else
+            if (d->type2.unit != 0) continue;
+            uint8_t ch = d->type2.channel;
+            uint16_t v = d->type2.data;
+#endif
+            for (uint8_t i = 0; i < numAxes; i++) {
+                if (channel[i] != ch) continue;
+                sum[i] += v;
+                n[i]++;
+                break;
+            }
+        }
+        for (uint8_t i = 0; i < numAxes; i++) {
+            if (n[i]) filters[i].push(sum[i] / n[i]);
+        }
+        numFrames++;
+    }
+};
+
+#endif
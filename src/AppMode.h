@@ -0,0 +1,101 @@
+#ifndef APP_MODE_H
+#define APP_MODE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "esp_bt.h"
+
+// Chọn chế độ chạy của firmware: tay cầm BLE, phát video, hay FlappyBird.
+// Chế độ lưu trong NVS; đổi bằng cách giữ nút lúc khởi động hoặc giữ tổ hợp
+// nút trong lúc chạy (lưu rồi khởi động lại, nên mỗi chế độ chỉ khởi tạo
+// đúng phần cứng nó cần).
+enum AppMode : uint8_t {
+    APP_GAMEPAD = 0,    // BLE, không màn hình
+    APP_VIDEO,          // màn hình, không BLE
+    APP_GAME,           // màn hình, không BLE
+    APP_MODE_COUNT
+};
+
+#define APP_CHORD_MS 1500           // giữ tổ hợp bao lâu thì đổi chế độ
+#define APP_CHORD_GAMEPAD_MS 5000   // ở chế độ tay cầm: tổ hợp 3 nút, giữ lâu hơn
+
+class AppModeManager {
+public:
+    // Đọc chế độ đã lưu; nút giữ lúc khởi động ghi đè:
+    //   giữ nút B -> video, giữ nút C -> game, giữ cả B và C -> tay cầm.
+    // (Không dùng GPIO0: giữ nó lúc reset là vào chế độ nạp.)
+    AppMode begin(int pinB, int pinC) {
+        pinMode(pinB, INPUT_PULLUP);
+        pinMode(pinC, INPUT_PULLUP);
+        delay(5);
+        bool b = digitalRead(pinB) == LOW;
+        bool c = digitalRead(pinC) == LOW;
+
+        prefs.begin("app", false);
+        uint8_t saved = prefs.getUChar("mode", APP_GAMEPAD);
+        current = saved < APP_MODE_COUNT ? (AppMode)saved : APP_GAMEPAD;
+        if (b && c) current = APP_GAMEPAD;
+        else if (b) current = APP_VIDEO;
+        else if (c) current = APP_GAME;
+        if (current != saved) prefs.putUChar("mode", current);
+
+        // Nút giữ lúc khởi động không được tính là tổ hợp đổi chế độ
+        chordSince = (b && c) ? (uint32_t)CHORD_BLOCKED : 0;
+        return current;
+    }
+
+    AppMode mode() const { return current; }
+
+    // Chế độ không dùng BLE: trả RAM của bộ điều khiển BT cho heap. Tách khỏi
+    // begin() để chế độ video gọi sau khi frame đầu đã lên màn hình.
+    void releaseRadio() {
+        if (current == APP_GAMEPAD || radioReleased) return;
+#if CONFIG_IDF_TARGET_ESP32
+        esp_bt_controller_mem_release(ESP_BT_MODE_BTDM);
+#else
+        esp_bt_controller_mem_release(ESP_BT_MODE_BLE);
+#endif
+        radioReleased = true;
+    }
+
+    // Gọi mỗi vòng loop với trạng thái tổ hợp: B và C cùng nhấn, riêng chế độ
+    // tay cầm là cả A, B, C (B+C là tổ hợp bình thường trong game trên host).
+    // Giữ đủ chordMs(): chuyển sang chế độ kế tiếp và khởi động lại.
+    void pollChord(bool held, uint32_t nowMs) {
+        if (!held) {
+            chordSince = 0;
+            return;
+        }
+        if (chordSince == CHORD_BLOCKED) return;
+        if (chordSince == 0) {
+            chordSince = nowMs ? nowMs : 1;
+            return;
+        }
+        if (nowMs - chordSince < chordMs()) return;
+        switchTo((AppMode)((current + 1) % APP_MODE_COUNT));
+    }
+
+    uint32_t chordMs() const { return current == APP_GAMEPAD ? APP_CHORD_GAMEPAD_MS : APP_CHORD_MS; }
+
+    void switchTo(AppMode m) {
+        prefs.putUChar("mode", m);
+        prefs.end();
+        Serial.printf("mode: %s -> %s, restart\n", name(current), name(m));
+        Serial.flush();
+        ESP.restart();
+    }
+
+    static const char* name(AppMode m) {
+        static const char* const names[APP_MODE_COUNT] = { "gamepad", "video", "game" };
+        return m < APP_MODE_COUNT ? names[m] : "?";
+    }
+
+private:
+    enum : uint32_t { CHORD_BLOCKED = 0xFFFFFFFFu };
+    Preferences prefs;
+    AppMode current = APP_GAMEPAD;
+    uint32_t chordSince = 0;
+    bool radioReleased = false;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef AXIS_FILTER_H
+#define AXIS_FILTER_H
+
+// Lọc 1 trục analog: trung vị trượt + hiệu chuẩn deadzone/thang đo + ngưỡng
+// gửi. Logic thuần, chạy được trên máy host với dãy mẫu giả lập.
+
+#include <stdint.h>
+
+#define AXIS_MEDIAN 3               // cửa sổ trung vị (lẻ), trễ thêm AXIS_MEDIAN/2 khung
+#define AXIS_OUT_MAX 32767          // thang trục của BleGamepad (0..32767)
+#define AXIS_OUT_CENTER 16384
+
+struct AxisCalibration {
+    uint16_t min;               // giá trị ADC thô ở 2 đầu hành trình
+    uint16_t center;            // điểm nghỉ; = min với cò (trigger) 1 chiều
+    uint16_t max;
+    uint16_t deadzone;          // quanh center (cần) hoặc đầu min (cò), đơn vị ADC thô
+    bool invert;
+};
+
+class AxisFilter {
+public:
+    void begin(const AxisCalibration& c) {
+        cal = c;
+        n = 0;
+        out = reported = rest();
+    }
+
+    // 1 mẫu đã oversample. Trả về giá trị trục sau lọc.
+    int16_t push(uint16_t raw) {
+        window[pos] = raw;
+        pos = (pos + 1) % AXIS_MEDIAN;
+        if (n < AXIS_MEDIAN) n++;
+        last = median();
+        if (learnRange) {
+            if (last < cal.min) cal.min = last;
+            if (last > cal.max) cal.max = last;
+        }
+        out = scale(last);
+        return out;
+    }
+
+    // Lấy điểm nghỉ hiện tại làm center (gọi lúc khởi động, tay không chạm cần)
+    void calibrateCenter() {
+        if (n && cal.center != cal.min) cal.center = last;
+    }
+
+    // Tự nới min/max khi gặp giá trị vượt hành trình đã biết
+    void setLearnRange(bool on) { learnRange = on; }
+
+    int16_t value() const { return out; }
+
+    // Có nên gửi: đổi quá ngưỡng, hoặc vừa về đúng điểm nghỉ/đầu hành trình
+    bool changed(uint16_t threshold) const {
+        if (out == reported) return false;
+        int32_t d = (int32_t)out - reported;
+        if (d < 0) d = -d;
+        return d >= threshold || out == rest() || out == 0 || out == AXIS_OUT_MAX;
+    }
+
+    void markReported() { reported = out; }
+
+    const AxisCalibration& calibration() const { return cal; }
+
+private:
+    AxisCalibration cal = { 0, 2048, 4095, 0, false };
+    uint16_t window[AXIS_MEDIAN] = {0};
+    uint8_t pos = 0;
+    uint8_t n = 0;
+    uint16_t last = 0;
+    int16_t out = 0;
+    int16_t reported = 0;
+    bool learnRange = false;
+
+    bool isTrigger() const { return cal.center <= cal.min; }
+    int16_t rest() const {
+        int16_t v = isTrigger() ? 0 : AXIS_OUT_CENTER;
+        return cal.invert ? AXIS_OUT_MAX - v : v;
+    }
+
+    uint16_t median() const {
+        uint16_t s[AXIS_MEDIAN];
+        for (uint8_t i = 0; i < n; i++) s[i] = window[i];
+        for (uint8_t i = 1; i < n; i++) {
+            uint16_t v = s[i];
+            int8_t j = i - 1;
+            while (j >= 0 && s[j] > v) {
+                s[j + 1] = s[j];
+                j--;
+            }
+            s[j + 1] = v;
+        }
+        return s[n / 2];
+    }
+
+    // Đoạn [a, b] -> [lo, hi], kẹp 2 đầu
+    static int32_t map(int32_t x, int32_t a, int32_t b, int32_t lo, int32_t hi) {
+        if (b <= a) return lo;
+        if (x <= a) return lo;
+        if (x >= b) return hi;
+        return lo + (x - a) * (hi - lo) / (b - a);
+    }
+
+    int16_t scale(uint16_t raw) const {
+        int32_t v;
+        if (isTrigger()) {
+            v = map(raw, cal.min + cal.deadzone, cal.max, 0, AXIS_OUT_MAX);
+        } else if (raw + cal.deadzone < cal.center) {
+            v = map(raw, cal.min, cal.center - cal.deadzone, 0, AXIS_OUT_CENTER);
+        } else if (raw > cal.center + cal.deadzone) {
+            v = map(raw, cal.center + cal.deadzone, cal.max, AXIS_OUT_CENTER, AXIS_OUT_MAX);
+        } else {
+            v = AXIS_OUT_CENTER;
+        }
+        return cal.invert ? AXIS_OUT_MAX - v : v;
+    }
+};
+
+#endif
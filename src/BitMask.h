@@ -0,0 +1,16 @@
+#ifndef BIT_MASK_H
+#define BIT_MASK_H
+
+#include <stdint.h>
+
+// Gọi f(i) cho từng bit đang bật, chi phí theo số bit bật chứ không theo 64
+template <typename F>
+inline void forEachBit(uint64_t mask, F f) {
+    while (mask) {
+        uint8_t i = __builtin_ctzll(mask);
+        mask &= mask - 1;
+        f(i);
+    }
+}
+
+#endif
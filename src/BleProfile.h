@@ -0,0 +1,77 @@
+#ifndef BLE_PROFILE_H
+#define BLE_PROFILE_H
+
+#include <NimBLEDevice.h>
+
+// Thông số kết nối BLE theo hồ sơ, đơn vị khoảng kết nối 1.25ms, timeout 10ms.
+// Host có thể từ chối hoặc làm tròn (iOS/macOS tối thiểu 15ms).
+struct BleConnProfile {
+    const char* name;
+    uint16_t minInterval;
+    uint16_t maxInterval;
+    uint16_t latency;           // số sự kiện kết nối thiết bị được bỏ qua
+    uint16_t timeout;
+};
+
+// 7.5ms, không bỏ sự kiện nào: report lên sóng sớm nhất có thể
+static const BleConnProfile BLE_PROFILE_LOW_LATENCY = { "low-latency", 6, 12, 0, 200 };
+// 30-50ms, bỏ tối đa 4 sự kiện khi không có gì gửi: radio ngủ lâu hơn
+static const BleConnProfile BLE_PROFILE_POWER_SAVER = { "power-saver", 24, 40, 4, 400 };
+
+#define BLE_PROFILE_IDLE_MS 30000   // không có input bao lâu thì chuyển sang tiết kiệm
+#define BLE_PROFILE_SETTLE_MS 2000  // chờ host ghép cặp/mã hoá xong mới đổi thông số
+
+// Tự chuyển hồ sơ theo hoạt động: có input -> low-latency, rảnh lâu -> power-saver
+class BleProfileManager {
+public:
+    // Gọi mỗi khi có nút đổi trạng thái
+    void activity(uint32_t nowMs) {
+        lastActivity = nowMs;
+        if (current != &BLE_PROFILE_LOW_LATENCY && connected && nowMs - connectedAt >= BLE_PROFILE_SETTLE_MS) {
+            apply(BLE_PROFILE_LOW_LATENCY);
+        }
+    }
+
+    // Gọi mỗi vòng loop
+    void update(uint32_t nowMs, bool isConnected) {
+        if (isConnected != connected) {
+            connected = isConnected;
+            connectedAt = nowMs;
+            lastActivity = nowMs;       // vừa nối: coi như đang chơi
+            current = nullptr;
+            return;
+        }
+        if (!connected || nowMs - connectedAt < BLE_PROFILE_SETTLE_MS) return;
+
+        const BleConnProfile& want = nowMs - lastActivity < BLE_PROFILE_IDLE_MS
+                                         ? BLE_PROFILE_LOW_LATENCY : BLE_PROFILE_POWER_SAVER;
+        if (current != &want) apply(want);
+    }
+
+    const BleConnProfile* profile() const { return current; }
+
+    // Khoảng kết nối ngắn nhất đã xin (µs): nhịp gửi report tối đa. Chưa xin
+    // thì coi như low-latency.
+    uint32_t intervalUs() const {
+        return (current ? current : &BLE_PROFILE_LOW_LATENCY)->minInterval * 1250u;
+    }
+
+private:
+    const BleConnProfile* current = nullptr;
+    bool connected = false;
+    uint32_t connectedAt = 0;
+    uint32_t lastActivity = 0;
+
+    void apply(const BleConnProfile& p) {
+        NimBLEServer* server = NimBLEDevice::getServer();
+        if (!server) return;
+        std::vector<uint16_t> peers = server->getPeerDevices();
+        for (size_t i = 0; i < peers.size(); i++) {
+            server->updateConnParams(peers[i], p.minInterval, p.maxInterval, p.latency, p.timeout);
+        }
+        current = &p;
+        Serial.printf("ble profile: %s\n", p.name);
+    }
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef BOOT_FRAME_H
+#define BOOT_FRAME_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <TFT_eSPI.h>
+#include "esp_timer.h"
+
+// Đường khởi động nhanh tới pixel đầu tiên của chế độ video.
+// TFT_eSPI::begin() reset panel rồi chạy bảng init đầy đủ với các delay an
+// toàn (~0.9 s với ST7735), sau đó mới fillScreen và decode JPEG đầu. Ở đây
+// panel được init tối giản theo datasheet ST7735S và frame đầu đã giải mã
+// sẵn lúc build (scripts/boot_frame.py) được đẩy thẳng qua SPI trong 1 lần.
+#if defined(__has_include)
+#if __has_include("boot_frame_data.h")
+#include "boot_frame_data.h"
+#endif
+#endif
+#ifndef BOOT_FRAME_WIDTH
+#define BOOT_FRAME_WIDTH 0          // chưa sinh frame (thiếu Pillow): bỏ đường nhanh
+#define BOOT_FRAME_HEIGHT 0
+#endif
+
+#define BOOT_PANEL_RESET_MS 120     // reset -> lệnh đầu, trường hợp xấu nhất (panel đang chạy)
+#define BOOT_PANEL_SLPOUT_MS 5      // SLPOUT -> lệnh kế tiếp
+
+uint32_t bootFirstPixelUs = 0;      // esp_timer lúc pixel đầu lên màn hình (0 = chưa có)
+bool bootFrameShown = false;
+
+// Ghi mốc pixel đầu tiên (chỉ lần đầu). esp_timer tính từ lúc app khởi động,
+// chưa gồm ROM và bootloader cấp 2.
+void markFirstPixel() {
+    if (bootFirstPixelUs) return;
+    bootFirstPixelUs = (uint32_t)esp_timer_get_time();
+    Serial.printf("boot: first pixel at %lu us%s\n", (unsigned long)bootFirstPixelUs,
+                  bootFrameShown ? " (boot frame)" : "");
+}
+
+// MADCTL của ST7735 theo rotation như setRotation() của TFT_eSPI
+// (MX|MY, MY|MV, 0, MX|MV), thứ tự màu theo TFT_RGB_ORDER
+constexpr uint8_t bootPanelMadctl(int rotation) {
+    return (rotation == 0 ? 0xC0 : rotation == 1 ? 0xA0 : rotation == 2 ? 0x00 : 0x60)
+         | (TFT_RGB_ORDER == TFT_BGR ? 0x08 : 0);
+}
+
+void bootPanelCommand(uint8_t cmd, const uint8_t* data = nullptr, uint8_t len = 0) {
+    digitalWrite(TFT_DC, LOW);
+    SPI.write(cmd);
+    digitalWrite(TFT_DC, HIGH);
+    if (len) SPI.writeBytes(data, len);
+}
+
+// Init tối giản + đẩy frame khởi động ở rotation/độ lệch GRAM của Screen.
+// Trả về false nếu không có frame.
+template <class Screen>
+bool showBootFrame() {
+#if BOOT_FRAME_WIDTH > 0
+    pinMode(TFT_CS, OUTPUT);
+    digitalWrite(TFT_CS, HIGH);
+    pinMode(TFT_DC, OUTPUT);
+    SPI.begin(TFT_SCLK, -1, TFT_MOSI, -1);
+    SPI.beginTransaction(SPISettings(SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+    digitalWrite(TFT_CS, LOW);
+
+#if defined(TFT_RST) && TFT_RST >= 0
+    pinMode(TFT_RST, OUTPUT);
+    digitalWrite(TFT_RST, LOW);
+    delayMicroseconds(20);          // xung reset tối thiểu 10 us
+    digitalWrite(TFT_RST, HIGH);
+#else
+    bootPanelCommand(0x01);         // SWRESET
+#endif
+    delay(BOOT_PANEL_RESET_MS);
+    bootPanelCommand(0x11);         // SLPOUT
+    delay(BOOT_PANEL_SLPOUT_MS);
+
+    // Các thanh ghi còn lại (gamma, nguồn, tần số quét) giữ mặc định sau reset;
+    // TFT_eSPI nạp đủ khi video bắt đầu
+    const uint8_t colmod = 0x05;    // 16 bit/pixel
+    const uint8_t madctl = bootPanelMadctl(Screen::ROTATION);
+    bootPanelCommand(0x3A, &colmod, 1);
+    bootPanelCommand(0x36, &madctl, 1);
+#ifdef TFT_INVERSION_ON
+    bootPanelCommand(0x21);         // INVON
+#endif
+
+    static_assert(BOOT_FRAME_WIDTH <= Screen::WIDTH && BOOT_FRAME_HEIGHT <= Screen::HEIGHT,
+                  "frame khởi động lớn hơn màn hình");
+    const uint16_t x0 = Screen::X_OFFSET + Screen::centerX(BOOT_FRAME_WIDTH);
+    const uint16_t y0 = Screen::Y_OFFSET + Screen::centerY(BOOT_FRAME_HEIGHT);
+    uint16_t x1 = x0 + BOOT_FRAME_WIDTH - 1, y1 = y0 + BOOT_FRAME_HEIGHT - 1;
+    const uint8_t caset[] = { (uint8_t)(x0 >> 8), (uint8_t)x0, (uint8_t)(x1 >> 8), (uint8_t)x1 };
+    const uint8_t raset[] = { (uint8_t)(y0 >> 8), (uint8_t)y0, (uint8_t)(y1 >> 8), (uint8_t)y1 };
+    bootPanelCommand(0x2A, caset, sizeof(caset));
+    bootPanelCommand(0x2B, raset, sizeof(raset));
+    bootPanelCommand(0x2C);         // RAMWR
+    SPI.writeBytes(bootFrame, sizeof(bootFrame));
+    bootPanelCommand(0x29);         // DISPON
+
+    digitalWrite(TFT_CS, HIGH);
+    SPI.endTransaction();
+    bootFrameShown = true;
+    markFirstPixel();
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Sau khi TFT_eSPI init lại panel (GRAM bị xoá): vẽ lại frame khởi động ngay.
+// Trả về false nếu không có frame hoặc frame không phủ kín màn hình.
+template <class Screen>
+bool redrawBootFrame(TFT_eSPI& tft) {
+#if BOOT_FRAME_WIDTH > 0
+    if (!bootFrameShown) return false;
+    if (BOOT_FRAME_WIDTH < Screen::WIDTH || BOOT_FRAME_HEIGHT < Screen::HEIGHT) return false;
+    // Dữ liệu đã ở thứ tự byte của panel: không đảo byte
+    bool swap = tft.getSwapBytes();
+    tft.setSwapBytes(false);
+    tft.pushImage(Screen::centerX(BOOT_FRAME_WIDTH), Screen::centerY(BOOT_FRAME_HEIGHT),
+                  BOOT_FRAME_WIDTH, BOOT_FRAME_HEIGHT, (const uint16_t*)bootFrame);
+    tft.setSwapBytes(swap);
+    return true;
+#else
+    (void)tft;
+    return false;
+#endif
+}
+
+#endif
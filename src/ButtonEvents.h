@@ -0,0 +1,121 @@
+#ifndef BUTTON_EVENTS_H
+#define BUTTON_EVENTS_H
+
+#include <Arduino.h>
+#include "driver/gpio.h"
+#include "esp_sleep.h"
+
+// Bắt cạnh nút bằng ngắt GPIO: ISR ghi (nút, mức, thời điểm) vào hàng đợi
+// vòng không khoá rồi đánh thức task loop, thay cho vòng quét delay(5).
+#define BUTTON_MAX 8
+#define BUTTON_QUEUE_SIZE 32        // lũy thừa của 2
+
+struct ButtonEvent {
+    uint32_t timeUs;                // micros() lúc có cạnh
+    uint8_t index;                  // thứ tự nút trong bảng chân
+    bool pressed;
+};
+
+// Hàng đợi 1 ghi (ISR) / 1 đọc (loop). ISR và loop chạy cùng core
+// nên chỉ cần chặn trình biên dịch đảo thứ tự ghi.
+template <uint8_t N>
+class ButtonQueue {
+public:
+    bool IRAM_ATTR push(const ButtonEvent& e) {
+        uint8_t h = head;
+        if ((uint8_t)(h - tail) >= N) {
+            dropped++;
+            return false;
+        }
+        buf[h & (N - 1)] = e;
+        __sync_synchronize();
+        head = h + 1;
+        return true;
+    }
+
+    bool pop(ButtonEvent& e) {
+        uint8_t t = tail;
+        if (t == head) return false;
+        e = buf[t & (N - 1)];
+        __sync_synchronize();
+        tail = t + 1;
+        return true;
+    }
+
+    uint32_t droppedCount() const { return dropped; }
+
+private:
+    ButtonEvent buf[N];
+    volatile uint8_t head = 0;
+    volatile uint8_t tail = 0;
+    volatile uint32_t dropped = 0;
+};
+
+class ButtonEvents {
+public:
+    // Gọi trong setup(): task gọi hàm này là task được đánh thức
+    void begin(const int* pins, uint8_t count) {
+        numPins = count < BUTTON_MAX ? count : BUTTON_MAX;
+        waiter = xTaskGetCurrentTaskHandle();
+        for (uint8_t i = 0; i < numPins; i++) {
+            slots[i].owner = this;
+            slots[i].pin = pins[i];
+            slots[i].index = i;
+            pinMode(pins[i], INPUT_PULLUP);
+            attachInterruptArg(digitalPinToInterrupt(pins[i]), onEdge, &slots[i], CHANGE);
+        }
+    }
+
+    // Dùng chân nút làm nguồn đánh thức light sleep. Light sleep chỉ đánh thức
+    // theo mức, nên ngắt đổi sang mức và ISR lật mức chờ sau mỗi cạnh
+    // (tương đương ngắt 2 cạnh).
+    void enableWakeup() {
+        wakeMode = true;
+        for (uint8_t i = 0; i < numPins; i++) armLevel(slots[i].pin, level(i));
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    // Chờ tới khi có cạnh hoặc hết timeoutMs
+    void wait(uint32_t timeoutMs) { ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)); }
+
+    bool pop(ButtonEvent& e) { return queue.pop(e); }
+
+    // Mức hiện tại (LOW = nhấn), dùng lúc khởi động
+    bool level(uint8_t i) const { return digitalRead(slots[i].pin) == LOW; }
+
+    uint32_t dropped() const { return queue.droppedCount(); }
+
+private:
+    struct Slot {
+        ButtonEvents* owner;
+        int pin;
+        uint8_t index;
+    };
+
+    ButtonQueue<BUTTON_QUEUE_SIZE> queue;
+    Slot slots[BUTTON_MAX];
+    uint8_t numPins = 0;
+    TaskHandle_t waiter = nullptr;
+    bool wakeMode = false;
+
+    // Chờ mức ngược với trạng thái hiện tại
+    static void IRAM_ATTR armLevel(int pin, bool pressed) {
+        gpio_wakeup_enable((gpio_num_t)pin, pressed ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    }
+
+    static void IRAM_ATTR onEdge(void* arg) {
+        Slot* s = (Slot*)arg;
+        ButtonEvent e;
+        e.timeUs = micros();
+        e.index = s->index;
+        e.pressed = digitalRead(s->pin) == LOW;
+        if (s->owner->wakeMode) armLevel(s->pin, e.pressed);
+        s->owner->queue.push(e);
+
+        BaseType_t woken = pdFALSE;
+        if (s->owner->waiter) vTaskNotifyGiveFromISR(s->owner->waiter, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef BUTTON_SCAN_H
+#define BUTTON_SCAN_H
+
+#include <Arduino.h>
+#include "soc/gpio_reg.h"
+#include "BitMask.h"
+
+// Đọc cả bank GPIO bằng 1 lần đọc thanh ghi rồi so bitmask bằng XOR,
+// thay vì digitalRead từng chân. Hỗ trợ nút nối thẳng (<= 64 chân) hoặc
+// ma trận hàng/cột tới 64 nút (cần diode chống ghosting nếu nhấn nhiều nút).
+#define BUTTON_SCAN_MAX 64
+#define BUTTON_MATRIX_SETTLE_US 3   // chờ cột ổn định sau khi kéo hàng xuống
+
+// Mức của mọi GPIO, bit n = GPIO n
+inline uint64_t gpioReadAll() {
+    uint64_t v = REG_READ(GPIO_IN_REG);
+#if SOC_GPIO_PIN_COUNT > 32
+    v |= (uint64_t)(REG_READ(GPIO_IN1_REG) & 0xFF) << 32;
+#endif
+    return v;
+}
+
+class ButtonScanner {
+public:
+    // Nút nối thẳng, nhấn = LOW. Nút logic i = pins[i].
+    void beginPins(const int* pins, uint8_t count) {
+        numRows = 0;
+        numButtons = count < BUTTON_SCAN_MAX ? count : BUTTON_SCAN_MAX;
+        pinMask = 0;
+        for (uint8_t i = 0; i < numButtons; i++) {
+            pinMode(pins[i], INPUT_PULLUP);
+            pinMask |= 1ULL << pins[i];
+            pinToButton[pins[i]] = i;
+        }
+        lastPins = 0;
+        logical = 0;
+    }
+
+    // Ma trận: hàng là output (kéo LOW lần lượt), cột là input pullup.
+    // Nút logic = hàng * numCols + cột.
+    void beginMatrix(const int* rowPins, uint8_t nr, const int* colPins, uint8_t nc) {
+        numRows = nr;
+        numCols = nc;
+        if (numRows * numCols > BUTTON_SCAN_MAX) numRows = BUTTON_SCAN_MAX / numCols;
+        numButtons = numRows * numCols;
+        pinMask = 0;
+        for (uint8_t c = 0; c < numCols; c++) {
+            pinMode(colPins[c], INPUT_PULLUP);
+            pinMask |= 1ULL << colPins[c];
+            cols[c] = colPins[c];
+        }
+        for (uint8_t r = 0; r < numRows; r++) {
+            pinMode(rowPins[r], OUTPUT);
+            digitalWrite(rowPins[r], HIGH);
+            rows[r] = rowPins[r];
+        }
+        logical = 0;
+    }
+
+    uint8_t count() const { return numButtons; }
+    bool isMatrix() const { return numRows > 0; }
+
+    // Quét 1 lượt, bit i = nút logic i đang nhấn (thô, chưa chống dội)
+    uint64_t scan() {
+        if (isMatrix()) return scanMatrix();
+
+        uint64_t pins = ~gpioReadAll() & pinMask;
+        uint64_t diff = pins ^ lastPins;
+        lastPins = pins;
+        forEachBit(diff, [this](uint8_t pin) { logical ^= 1ULL << pinToButton[pin]; });
+        return logical;
+    }
+
+private:
+    uint64_t pinMask = 0;
+    uint64_t lastPins = 0;
+    uint64_t logical = 0;
+    uint8_t numButtons = 0;
+    uint8_t pinToButton[64];
+    uint8_t numRows = 0;
+    uint8_t numCols = 0;
+    int8_t rows[BUTTON_SCAN_MAX];
+    int8_t cols[BUTTON_SCAN_MAX];
+
+    uint64_t scanMatrix() {
+        uint64_t state = 0;
+        for (uint8_t r = 0; r < numRows; r++) {
+            digitalWrite(rows[r], LOW);
+            delayMicroseconds(BUTTON_MATRIX_SETTLE_US);
+            uint64_t pins = ~gpioReadAll() & pinMask;   // 1 lần đọc cho cả hàng
+            digitalWrite(rows[r], HIGH);
+            if (!pins) continue;
+            for (uint8_t c = 0; c < numCols; c++) {
+                if (pins & (1ULL << cols[c])) state |= 1ULL << (r * numCols + c);
+            }
+        }
+        logical = state;
+        return state;
+    }
+};
+
+#endif
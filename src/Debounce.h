@@ -0,0 +1,126 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+// Chống dội phím theo cạnh có đóng dấu thời gian (micro giây). Logic thuần,
+// không phụ thuộc Arduino: chạy được trên máy host với chuỗi cạnh giả lập.
+
+#include <stdint.h>
+
+enum DebounceMode : uint8_t {
+    DEBOUNCE_INTEGRATOR = 0,    // mức thô phải đứng yên đủ lâu mới nhận (cả nhấn lẫn nhả)
+    DEBOUNCE_EAGER              // nhận nhấn ngay, nhả phải đứng yên đủ lâu
+};
+
+struct DebounceConfig {
+    DebounceMode mode;
+    uint32_t pressUs;           // integrator: thời gian ổn định khi nhấn; eager: khoá sau khi nhả
+    uint32_t releaseUs;         // thời gian ổn định khi nhả
+};
+
+#define DEBOUNCE_NEVER 0xFFFFFFFFu
+
+class Debouncer {
+public:
+    void begin(const DebounceConfig& c, bool level, uint32_t now) {
+        cfg = c;
+        state = raw = level;
+        rawSince = acceptedAt = edgeAt = now;
+        filtered = 0;
+    }
+
+    // 1 cạnh thô tại thời điểm t. Trả về true nếu trạng thái đã lọc đổi.
+    bool edge(bool level, uint32_t t) {
+        if (level == raw) return false;
+        raw = level;
+        rawSince = t;
+        if (raw == state) {
+            filtered++;             // thay đổi đang chờ bị huỷ: 1 lần dội
+            return false;
+        }
+        return poll(t);
+    }
+
+    // Cho thời gian trôi tới now, nhận thay đổi đang chờ nếu đã đủ lâu
+    bool poll(uint32_t now) {
+        if (raw == state || (int32_t)(now - readyAt()) < 0) return false;
+        state = raw;
+        edgeAt = rawSince;
+        acceptedAt = now;
+        return true;
+    }
+
+    // Micro giây tới lúc cần poll lại, DEBOUNCE_NEVER nếu không có gì chờ
+    uint32_t remaining(uint32_t now) const {
+        if (raw == state) return DEBOUNCE_NEVER;
+        int32_t d = (int32_t)(readyAt() - now);
+        return d > 0 ? (uint32_t)d : 0;
+    }
+
+    bool pending() const { return raw != state; }
+    uint32_t deadline() const { return readyAt(); }     // chỉ có nghĩa khi pending()
+
+    bool pressed() const { return state; }
+    uint32_t edgeTime() const { return edgeAt; }       // cạnh thô gây ra thay đổi cuối
+    uint32_t acceptTime() const { return acceptedAt; } // lúc nhận thay đổi cuối
+    uint32_t bounces() const { return filtered; }
+
+private:
+    DebounceConfig cfg = { DEBOUNCE_INTEGRATOR, 5000, 5000 };
+    bool state = false;         // trạng thái đã lọc
+    bool raw = false;           // mức thô gần nhất
+    uint32_t rawSince = 0;
+    uint32_t acceptedAt = 0;
+    uint32_t edgeAt = 0;
+    uint32_t filtered = 0;
+
+    uint32_t readyAt() const {
+        if (cfg.mode == DEBOUNCE_EAGER) {
+            return raw ? acceptedAt + cfg.pressUs : rawSince + cfg.releaseUs;
+        }
+        return rawSince + (raw ? cfg.pressUs : cfg.releaseUs);
+    }
+};
+
+// 1 cạnh trong chuỗi giả lập
+struct DebounceEdge {
+    uint32_t timeUs;
+    bool level;
+};
+
+struct DebounceTraceResult {
+    uint16_t presses;           // số lần nhấn đã lọc
+    uint16_t releases;
+    uint32_t bounces;
+    uint32_t worstDelayUs;      // trễ lớn nhất từ cạnh thô tới lúc nhận
+};
+
+inline void traceCount(DebounceTraceResult& r, const Debouncer& d, uint32_t at) {
+    if (d.pressed()) r.presses++;
+    else r.releases++;
+    uint32_t delay = at - d.edgeTime();
+    if (delay > r.worstDelayUs) r.worstDelayUs = delay;
+}
+
+// Chạy chuỗi cạnh qua bộ lọc, poll đúng hạn chót như loop thật (test/test_debounce)
+inline DebounceTraceResult debounceTrace(const DebounceConfig& cfg, bool initial,
+                                         const DebounceEdge* edges, uint16_t count,
+                                         uint32_t endUs) {
+    DebounceTraceResult r = { 0, 0, 0, 0 };
+    Debouncer d;
+    d.begin(cfg, initial, count ? edges[0].timeUs - cfg.pressUs - cfg.releaseUs : 0);
+    for (uint16_t i = 0; i <= count; i++) {
+        uint32_t t = i < count ? edges[i].timeUs : endUs;
+        bool changed = false;
+        uint32_t at = t;
+        if (d.pending() && (int32_t)(d.deadline() - t) <= 0) {
+            at = d.deadline();
+            changed = d.poll(at);
+        }
+        if (changed) traceCount(r, d, at);
+        if (i < count && d.edge(edges[i].level, t)) traceCount(r, d, t);
+    }
+    r.bounces = d.bounces();
+    return r;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+#include <stdint.h>
+#include "Panel.h"
+
+struct DirtyRect {
+    int16_t x, y, w, h;
+
+    int32_t area() const { return (int32_t)w * h; }
+
+    // Chạm hoặc chồng lên nhau (gộp được mà không tốn thêm nhiều pixel)
+    bool touches(const DirtyRect& o) const {
+        return x <= o.x + o.w && o.x <= x + w && y <= o.y + o.h && o.y <= y + h;
+    }
+
+    DirtyRect unite(const DirtyRect& o) const {
+        int16_t x0 = x < o.x ? x : o.x;
+        int16_t y0 = y < o.y ? y : o.y;
+        int16_t x1 = (x + w > o.x + o.w) ? x + w : o.x + o.w;
+        int16_t y1 = (y + h > o.y + o.h) ? y + h : o.y + o.h;
+        return { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    }
+};
+
+// Danh sách vùng thay đổi trong 1 tick, cắt theo màn hình Screen (PanelView)
+// và tự gộp các vùng chồng nhau. Khi đầy thì gộp vào vùng tăng diện tích ít nhất.
+template <class Screen, uint8_t N>
+class DirtyRectList {
+public:
+    void clear() { n = 0; }
+    uint8_t count() const { return n; }
+    const DirtyRect& operator[](uint8_t i) const { return rects[i]; }
+
+    int32_t area() const {
+        int32_t a = 0;
+        for (uint8_t i = 0; i < n; i++) a += rects[i].area();
+        return a;
+    }
+
+    void add(int16_t x, int16_t y, int16_t w, int16_t h) {
+        // Cắt theo biên màn hình
+        int16_t cw = Screen::clipW(x, w), ch = Screen::clipH(y, h);
+        if (cw <= 0 || ch <= 0) return;
+
+        DirtyRect r = { (int16_t)(x < 0 ? 0 : x), (int16_t)(y < 0 ? 0 : y), cw, ch };
+
+        // Gộp liên tiếp cho tới khi không còn vùng nào chạm r
+        for (uint8_t i = 0; i < n;) {
+            if (rects[i].touches(r)) {
+                r = rects[i].unite(r);
+                rects[i] = rects[--n];
+                i = 0;
+            } else {
+                i++;
+            }
+        }
+
+        if (n < N) {
+            rects[n++] = r;
+            return;
+        }
+
+        uint8_t best = 0;
+        int32_t bestGrow = INT32_MAX;
+        for (uint8_t i = 0; i < n; i++) {
+            int32_t grow = rects[i].unite(r).area() - rects[i].area();
+            if (grow < bestGrow) {
+                bestGrow = grow;
+                best = i;
+            }
+        }
+        rects[best] = rects[best].unite(r);
+    }
+
+private:
+    DirtyRect rects[N];
+    uint8_t n = 0;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef FLAPPY_BENCH_H
+#define FLAPPY_BENCH_H
+
+// Đo thông lượng logic FlappyBird không vẽ: chạy N tick với bot tự chơi,
+// ván kết thúc thì reset seed kế tiếp. Dùng được trên máy host (truyền hàm
+// đồng hồ micro giây) lẫn trên ESP32 (micros): test/test_flappy_bench.
+
+#include "FlappySim.h"
+
+enum FlappyDriver : uint8_t {
+    FLAPPY_DRIVER_RANDOM = 0,   // nhấn ngẫu nhiên ~1/8 số tick
+    FLAPPY_DRIVER_AUTO          // bot bám tâm khe ống
+};
+
+// Bot: nhấn khi chim đang rơi và thấp hơn tâm khe của ống kế tiếp
+template <class Screen, class Physics>
+bool flappyAutoPilot(const FlappySim<Screen, Physics>& sim) {
+    int p = sim.nextPipe();
+    int gapCenter = p < 0 ? sim.SCREEN_H / 2 : sim.ents.y[p] + sim.ents.h[p] / 2;
+    return sim.velocity > 0 && sim.birdY + sim.birdSize / 2 > gapCenter + sim.scaled(6);
+}
+
+struct FlappyBenchResult {
+    uint32_t ticks;
+    uint32_t runs;          // số ván đã chơi
+    int bestScore;
+    uint32_t elapsedUs;
+    int32_t heapDelta;      // byte heap bị chiếm thêm trong lúc chạy (0 nếu không đo)
+
+    uint32_t ticksPerSecond() const {
+        return elapsedUs ? (uint32_t)((uint64_t)ticks * 1000000 / elapsedUs) : 0;
+    }
+};
+
+// Screen: sân chơi như FlappyBird<Screen>; clock: micro giây;
+// freeHeap: heap còn trống (nullptr = không đo)
+template <class Screen>
+FlappyBenchResult flappyBench(uint32_t ticks, FlappyDriver driver, uint32_t seed,
+                              uint32_t (*clock)(), uint32_t (*freeHeap)() = nullptr) {
+    FlappySim<Screen> sim;
+    FlappyRng input;
+    input.seed(seed ^ 0xA5A5A5A5u);
+
+    FlappyBenchResult r = { 0, 1, 0, 0, 0 };
+    uint32_t heapBefore = freeHeap ? freeHeap() : 0;
+    uint32_t start = clock();
+
+    sim.reset(seed);
+    while (r.ticks < ticks) {
+        bool flap = driver == FLAPPY_DRIVER_AUTO ? flappyAutoPilot(sim)
+                                                 : (input.next() & 7) == 0;
+        sim.step(flap);
+        r.ticks++;
+        if (sim.gameOver) {
+            if (sim.score > r.bestScore) r.bestScore = sim.score;
+            sim.reset(seed + r.runs++);
+        }
+    }
+    if (sim.score > r.bestScore) r.bestScore = sim.score;
+
+    r.elapsedUs = clock() - start;
+    if (freeHeap) r.heapDelta = (int32_t)(heapBefore - freeHeap());
+    return r;
+}
+
+#endif
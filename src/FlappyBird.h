@@ -3,74 +3,124 @@
 
 #include <TFT_eSPI.h>
 #include <SPI.h>
+#include "DirtyRects.h"
+#include "FlappySim.h"
+#include "FlappyTiles.h"
+#include "HwScroll.h"
+#include "Panel.h"
 
+// Chiều cao 1 dải khi không đủ RAM cho back-buffer cả màn hình
+#define FLAPPY_BAND_H 20
+
+// Bước vật lý cố định và số bước tối đa mỗi lần update() trước khi bỏ bớt
+#define FLAPPY_TICK_MS 20
+#define FLAPPY_MAX_STEPS 5
+// Thời gian chờ sau GAME OVER trước khi nhận nút chơi lại
+#define FLAPPY_RESTART_MS 1000
+
+// Số lần đổi trạng thái nút tối đa lưu trong nhật ký 1 ván
+#define FLAPPY_LOG_SIZE 512
+
+// Bật để in seed + nhật ký input ra Serial khi GAME OVER (để replay)
+// #define FLAPPY_REPLAY_LOG
+
+// Bật để in số byte SPI mỗi tick ra Serial
+// #define FLAPPY_SPI_STATS
+
+// Screen: PanelView của màn hình (kích thước sân chơi = màn hình sau
+// setRotation(Screen::ROTATION)). Chiều ngang trên ST7735 dùng cuộn phần cứng cho nền.
+template <class Screen>
 class FlappyBird {
 public:
     FlappyBird(TFT_eSPI &display, int btnPin)
-        : tft(display), BTN_PIN(btnPin) {}
+        : tft(display), BTN_PIN(btnPin), canvas(&display), scroller(display) {}
 
-    void begin() {
+    // seed = 0: lấy seed ngẫu nhiên từ phần cứng; seed khác 0 để chơi lại đúng 1 ván
+    void begin(uint32_t seed = 0) {
         pinMode(BTN_PIN, INPUT_PULLUP);
+
+        // Back-buffer: ưu tiên cả màn hình, thiếu RAM thì dùng dải ngang
+        canvasH = SCREEN_H;
+        if (!canvas.createSprite(SCREEN_W, canvasH)) {
+            canvasH = FLAPPY_BAND_H;
+            if (!canvas.createSprite(SCREEN_W, canvasH)) canvasH = 0;
+        }
+        tilesReady = tiles.build(sim.pipeWidth, SCREEN_H - groundTop());
+        scaleBird();
+        scroller.begin(SCREEN_W);
+
         tft.fillScreen(TFT_CYAN);
-        randomSeed(analogRead(0));
+        fixedSeed = seed;
         resetGame();
     }
 
+    // Nút từ dịch vụ input chung: đã chống dội, pressMs/releaseMs = millis() lúc
+    // cạnh nhấn/nhả. Gọi trước mỗi update(); từ lần gọi đầu update() không tự
+    // đọc chân nút nữa.
+    void setButton(bool held, bool pressedEdge, uint32_t pressMs, bool releasedEdge, uint32_t releaseMs) {
+        externalInput = true;
+        if (pressedEdge) pressAt(pressMs);
+        if (releasedEdge) releaseAt = releaseMs;
+        btnHeld = held;
+    }
+
+    // Không chặn: gọi liên tục trong loop(). Vật lý chạy theo bước cố định
+    // FLAPPY_TICK_MS, màn hình vẽ lại 1 lần sau mỗi loạt bước (bỏ frame khi tải nặng).
+    // Lần nhấn và lần nhả được tính vào đúng tick chứa thời điểm cạnh.
     void update() {
-        if (!gameOver) {
-            // Xóa chim cũ
-            tft.fillRect(birdX, oldBirdY, birdSize, birdSize, TFT_CYAN);
-            // Xóa ống cũ
-            drawPipe(oldPipeX, pipeTopHeight, TFT_CYAN);
-            drawGround();
-
-            // Nhảy
-            if (digitalRead(BTN_PIN) == LOW) velocity = jumpStrength;
-
-            // Cập nhật chim
-            oldBirdY = birdY;
-            velocity += gravity;
-            birdY += velocity;
-
-            // Cập nhật ống
-            oldPipeX = pipeX;
-            pipeX -= 2;
-            if (pipeX + pipeWidth < 0) {
-                pipeX = SCREEN_W;
-                pipeTopHeight = random(20, SCREEN_H - pipeGap - 20);
-                score++;
+        uint32_t now = millis();
+
+        if (!externalInput) {
+            bool pressed = digitalRead(BTN_PIN) == LOW;
+            if (pressed && !btnHeld) pressAt(now);
+            if (!pressed && btnHeld) releaseAt = now;
+            btnHeld = pressed;
+        }
+
+        if (!sim.gameOver) {
+            accumulator += now - lastUpdate;
+            lastUpdate = now;
+
+            // Tick kế tiếp phủ [tickStart, tickStart + FLAPPY_TICK_MS)
+            uint32_t tickStart = now - accumulator;
+            uint8_t steps = 0;
+            while (accumulator >= FLAPPY_TICK_MS && steps < FLAPPY_MAX_STEPS && !sim.gameOver) {
+                step(flapAt(tickStart));
+                tickStart += FLAPPY_TICK_MS;
+                accumulator -= FLAPPY_TICK_MS;
+                steps++;
             }
+            // Tụt quá xa (vd. vừa bị chặn lâu): bỏ phần tồn đọng thay vì tua nhanh
+            if (accumulator >= FLAPPY_TICK_MS * FLAPPY_MAX_STEPS) accumulator = 0;
+
+            // Chỉ vẽ lại những vùng thay đổi
+            if (steps) render();
 
-            // Vẽ mới
-            drawSprite(birdX, birdY, birdSprite, birdSize, birdSize);
-            drawPipe(pipeX, pipeTopHeight, TFT_GREEN);
-            drawGround();
-
-            // Điểm
-            tft.setTextColor(TFT_WHITE, TFT_CYAN);
-            tft.setTextSize(2);
-            tft.setCursor(5, 5);
-            tft.print(score);
-
-            // Va chạm
-            if (birdY < 0 || birdY + birdSize > SCREEN_H - 16 ||
-                (birdX + birdSize > pipeX && birdX < pipeX + pipeWidth &&
-                 (birdY < pipeTopHeight || birdY + birdSize > pipeTopHeight + pipeGap))) {
-                gameOver = true;
+            if (sim.gameOver) {
+                gameOverAt = now;
+                // Chữ GAME OVER vẽ theo toạ độ màn hình: bỏ cuộn trước
+                if (scroller.enabled()) redrawAll();
+                drawGameOver();
+#ifdef FLAPPY_REPLAY_LOG
+                printReplay();
+#endif
             }
+        } else if (now - gameOverAt >= FLAPPY_RESTART_MS && btnHeld) {
+            resetGame();
+        }
+    }
 
-            delay(20);
-        } else {
-            tft.setTextColor(TFT_RED, TFT_CYAN);
-            tft.setTextSize(2);
-            tft.setCursor(5, SCREEN_H / 2 - 10);
-            tft.print("GAME OVER");
-            tft.setCursor(5, SCREEN_H / 2 + 10);
-            tft.print("Score:");
-            tft.print(score);
+    // Seed và nhật ký (tick, pressed) của ván hiện tại, dùng với flappyReplay()
+    uint32_t seed() const { return sim.seed(); }
+    const FlappyInputLog<FLAPPY_LOG_SIZE>& inputs() const { return inputLog; }
 
-            delay(1000);
-            if (digitalRead(BTN_PIN) == LOW) resetGame();
+    void printReplay() const {
+        Serial.printf("seed=%lu ticks=%lu score=%d inputs=%u%s\n",
+                      (unsigned long)sim.seed(), (unsigned long)sim.tick, sim.score,
+                      inputLog.count(), inputLog.overflowed() ? " (tran)" : "");
+        for (uint16_t i = 0; i < inputLog.count(); i++) {
+            Serial.printf("%lu,%d\n", (unsigned long)inputLog.data()[i].tick,
+                          inputLog.data()[i].pressed);
         }
     }
 
@@ -78,31 +128,53 @@ private:
     TFT_eSPI &tft;
     int BTN_PIN;
 
-    // Màn hình
-    const int SCREEN_W = 80;
-    const int SCREEN_H = 160;
-
-    // Chim
-    int birdX = 20;
-    int birdY = 80;
-    int birdSize = 8;
-    float velocity = 0;
-    float gravity = 0.4;
-    float jumpStrength = -4.5;
-
-    // Ống
-    int pipeX = SCREEN_W;
-    int pipeGap = 45;
-    int pipeWidth = 15;
-    int pipeTopHeight;
-
-    // Game
-    bool gameOver = false;
-    int score = 0;
-    int oldBirdY = birdY, oldPipeX = pipeX;
-
-    // Sprite chim 8x8
-    const uint16_t birdSprite[8*8] = {
+    // Logic game (vật lý, ống, điểm) và nhật ký input để replay
+    FlappySim<Screen> sim;
+    FlappyInputLog<FLAPPY_LOG_SIZE> inputLog;
+    uint32_t fixedSeed = 0;
+
+    // Tên ngắn cho phần vẽ
+    enum : int { SCREEN_W = Screen::WIDTH, SCREEN_H = Screen::HEIGHT };
+
+    // Vòng lặp bước cố định
+    uint32_t lastUpdate = 0, accumulator = 0, gameOverAt = 0;
+
+    // Nút: lần nhấn chờ tick của nó, và khoảng giữ để vỗ liên tục khi giữ nút
+    bool externalInput = false;
+    bool btnHeld = false;
+    bool flapQueued = false;
+    uint32_t pressedAt = 0, releaseAt = 0;
+
+    // Trạng thái đang hiển thị trên màn hình (để tính vùng thay đổi)
+    DirtyRectList<Screen, 16> dirty;
+    int drawnBirdY, drawnScore;
+    uint16_t drawnActive;
+    int16_t drawnX[FLAPPY_MAX_ENTITIES], drawnY[FLAPPY_MAX_ENTITIES];
+    uint8_t drawnKind[FLAPPY_MAX_ENTITIES];
+
+    // Back-buffer RGB565, cao canvasH (0 = vẽ thẳng lên màn hình)
+    TFT_eSprite canvas;
+    int canvasH = 0;
+
+    // Tile ống/đất dựng sẵn; đất cuộn theo tick, vẽ lại khi offset đổi
+    FlappyTiles<Screen> tiles;
+    bool tilesReady = false;
+    uint32_t drawnGroundScroll = 0;
+
+    // Cuộn phần cứng (chỉ ST7735 chiều ngang): nền nằm yên trong GRAM,
+    // mỗi tick chỉ vẽ dải cột mới lộ ra cùng chim/điểm/vật di động
+    HwScroll<Screen> scroller;
+    uint32_t drawnScrollTotal = 0;
+
+#ifdef FLAPPY_SPI_STATS
+    // Thống kê byte SPI: thực tế và ước lượng cách vẽ cũ (xoá + vẽ lại tất cả)
+    uint32_t spiBytes = 0, legacySpiBytes = 0, statTicks = 0;
+#endif
+
+    // Sprite chim thiết kế 8x8, và bản thu/phóng theo sim.birdSize để vẽ
+    enum : int { BIRD_PX = FlappySim<Screen>::scaled(FLAPPY_BIRD_PX) };
+    uint16_t birdPixels[BIRD_PX * BIRD_PX];
+    const uint16_t birdSprite[FLAPPY_BIRD_PX * FLAPPY_BIRD_PX] = {
         0xFFFF,0xFFFF,0xFFE0,0xFFE0,0xFFE0,0xFFFF,0xFFFF,0xFFFF,
         0xFFFF,0xFFE0,0xFFE0,0xFFE0,0xFFE0,0xFFE0,0xFFFF,0xFFFF,
         0xFFFF,0xFFE0,0xFFFF,0xFFFF,0xFFFF,0xFFE0,0xFFE0,0xFFFF,
@@ -113,34 +185,388 @@ private:
         0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF
     };
 
+    // Lấy mẫu điểm giữa mỗi ô (giữ được mắt chim khi thu nhỏ)
+    void scaleBird() {
+        for (int y = 0; y < BIRD_PX; y++) {
+            for (int x = 0; x < BIRD_PX; x++) {
+                int sy = (2 * y + 1) * FLAPPY_BIRD_PX / (2 * BIRD_PX);
+                int sx = (2 * x + 1) * FLAPPY_BIRD_PX / (2 * BIRD_PX);
+                birdPixels[y * BIRD_PX + x] = birdSprite[sy * FLAPPY_BIRD_PX + sx];
+            }
+        }
+    }
+
+    // Mặt cỏ: đất vẽ từ đây xuống đáy, cỏ phủ FLAPPY_GRASS_H dòng trên vạch va chạm
+    int groundTop() const { return sim.groundY - FLAPPY_GRASS_H; }
+
     void resetGame() {
-        birdY = SCREEN_H / 2;
-        velocity = 0;
-        pipeX = SCREEN_W;
-        pipeTopHeight = random(20, SCREEN_H - pipeGap - 20);
-        score = 0;
-        gameOver = false;
-        tft.fillScreen(TFT_CYAN);
-        drawGround();
+        sim.reset(fixedSeed ? fixedSeed : esp_random());
+        inputLog.clear();
+        flapQueued = false;
+        accumulator = 0;
+        lastUpdate = millis();
+        redrawAll();
+    }
+
+    // Vẽ lại toàn bộ màn hình, không cuộn
+    void redrawAll() {
+        scroller.set(0);
+        drawnBirdY = sim.birdY;
+        drawnScore = sim.score;
+        drawnGroundScroll = groundScroll();
+        drawnScrollTotal = scrollTotal();
+        rememberEntities();
+        dirty.clear();
+        dirty.add(0, 0, SCREEN_W, SCREEN_H);
+        flush();
+    }
+
+#ifdef FLAPPY_SPI_STATS
+    // Mỗi lần mở cửa sổ: CASET + RASET + RAMWR = 3 byte lệnh + 8 byte tham số
+    static const uint32_t WINDOW_BYTES = 11;
+
+    static uint32_t rectBytes(int w, int h) {
+        return (w > 0 && h > 0) ? (uint32_t)w * h * 2 + WINDOW_BYTES : 0;
+    }
+
+    // Số byte cách vẽ cũ đẩy mỗi tick: xoá + vẽ chim, ống (fill + viền), đất 2 lần, điểm
+    uint32_t legacyTickBytes() const {
+        uint32_t pipe = 0;
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (!sim.ents.isActive(i)) continue;
+            if (sim.ents.kind[i] != FLAPPY_PIPE) {
+                pipe += rectBytes(sim.ents.w[i], sim.ents.h[i]);
+                continue;
+            }
+            int topH = sim.ents.y[i];
+            int botH = sim.groundY - (topH + sim.pipeGap);
+            pipe += rectBytes(sim.pipeWidth, topH) + rectBytes(sim.pipeWidth, botH)
+                  + 4 * rectBytes(sim.pipeWidth, 1) + 2 * rectBytes(1, topH) + 2 * rectBytes(1, botH);
+        }
+        uint32_t ground = rectBytes(SCREEN_W, SCREEN_H - sim.groundY) + rectBytes(SCREEN_W, FLAPPY_GRASS_H);
+        uint32_t digits = sim.score < 10 ? 1 : sim.score < 100 ? 2 : 3;
+        return 2 * (rectBytes(sim.birdSize, sim.birdSize) + pipe + ground) + digits * rectBytes(12, 16);
+    }
+
+    void countSpi(int w, int h) { spiBytes += rectBytes(w, h); }
+
+    void reportSpiStats() {
+        legacySpiBytes += legacyTickBytes();
+        if (++statTicks < 100) return;
+        Serial.printf("SPI/tick: %lu B (cach cu: %lu B)\n",
+                      (unsigned long)(spiBytes / statTicks),
+                      (unsigned long)(legacySpiBytes / statTicks));
+        spiBytes = legacySpiBytes = statTicks = 0;
+    }
+#else
+    // Bản phát hành: không tính thống kê
+    void countSpi(int, int) {}
+    void reportSpiStats() {}
+#endif
+
+    void pressAt(uint32_t t) {
+        flapQueued = true;
+        pressedAt = t;
+    }
+
+    // Tick bắt đầu lúc start có vỗ không: lần nhấn rơi vào (hoặc trước) tick
+    // này, hoặc nút đang được giữ từ trước đầu tick
+    bool flapAt(uint32_t start) {
+        if (flapQueued && (int32_t)(pressedAt - (start + FLAPPY_TICK_MS)) < 0) {
+            flapQueued = false;
+            return true;
+        }
+        if (flapQueued || (int32_t)(pressedAt - start) > 0) return false;
+        return btnHeld || (int32_t)(releaseAt - start) > 0;
+    }
+
+    // 1 bước vật lý FLAPPY_TICK_MS
+    void step(bool flap) {
+        inputLog.record(sim.tick, flap);
+        sim.step(flap);
+    }
+
+    void drawGameOver() {
+        tft.setTextColor(TFT_RED, TFT_CYAN);
+        tft.setTextSize(2);
+        tft.setCursor(5, SCREEN_H / 2 - 10);
+        tft.print("GAME OVER");
+        tft.setCursor(5, SCREEN_H / 2 + 10);
+        tft.print("Score:");
+        tft.print(sim.score);
+    }
+
+    // So sánh trạng thái mới với những gì đang hiển thị, ghi lại vùng thay đổi
+    void render() {
+        if (scroller.enabled()) {
+            renderScrolled();
+            return;
+        }
+        dirty.clear();
+
+        if (sim.birdY != drawnBirdY) {
+            dirty.add(sim.birdX, drawnBirdY, sim.birdSize, sim.birdSize);
+            dirty.add(sim.birdX, sim.birdY, sim.birdSize, sim.birdSize);
+        }
+
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            bool was = drawnActive & (1u << i);
+            bool now = sim.ents.isActive(i);
+            if (!was && !now) continue;
+
+            bool sameKind = was && now && drawnKind[i] == sim.ents.kind[i];
+            if (sameKind && drawnX[i] == sim.ents.x[i] && drawnY[i] == sim.ents.y[i]) continue;
+
+            if (sameKind && sim.ents.kind[i] == FLAPPY_PIPE) {
+                markPipeMoved(drawnX[i], drawnY[i], sim.ents.x[i], sim.ents.y[i]);
+            } else {
+                if (was) markEntity(drawnKind[i], drawnX[i], drawnY[i]);
+                if (now) markEntity(sim.ents.kind[i], sim.ents.x[i], sim.ents.y[i]);
+            }
+        }
+
+        // Cuộn chỉ đổi các dòng đất có hoa văn; đất màu trơn (chưa có tile)
+        // hay offset trong FLAPPY_GROUND_PERIOD chưa đổi thì không gửi lại
+        if (tilesReady && groundScroll() != drawnGroundScroll) {
+            int y = groundTop() + tiles.scrollRow;
+            dirty.add(0, y, SCREEN_W, SCREEN_H - y);
+        }
+
+        if (sim.score != drawnScore) {
+            // Chữ size 2: 12x16 px mỗi ký tự, đủ cho 3 chữ số
+            dirty.add(5, 5, 36, 16);
+        }
+
+        drawnBirdY = sim.birdY;
+        drawnScore = sim.score;
+        drawnGroundScroll = groundScroll();
+        rememberEntities();
+        flush();
+        reportSpiStats();
+    }
+
+    // Cuộn phần cứng: dịch GRAM theo quãng nền đã trôi, ảnh cũ của mọi thứ
+    // đều trôi sang trái dx px. Chỉ vẽ dải mới lộ ra và những gì không trôi
+    // theo nền (chim, điểm, vật cản lên xuống, xu đã ăn).
+    void renderScrolled() {
+        dirty.clear();
+        int dx = scrollTotal() - drawnScrollTotal;
+
+        if (dx >= SCREEN_W) {
+            dirty.add(0, 0, SCREEN_W, SCREEN_H);
+        } else {
+            if (dx > 0) dirty.add(SCREEN_W - dx, 0, dx, SCREEN_H);
+
+            if (dx || sim.birdY != drawnBirdY) {
+                dirty.add(sim.birdX - dx, drawnBirdY, sim.birdSize, sim.birdSize);
+                dirty.add(sim.birdX, sim.birdY, sim.birdSize, sim.birdSize);
+            }
+            if (dx || sim.score != drawnScore) {
+                dirty.add(5 - dx, 5, 36, 16);
+                dirty.add(5, 5, 36, 16);
+            }
+
+            for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+                bool was = drawnActive & (1u << i);
+                bool now = sim.ents.isActive(i);
+                bool sameKind = was && now && drawnKind[i] == sim.ents.kind[i];
+                if (sameKind && drawnX[i] - dx == sim.ents.x[i] && drawnY[i] == sim.ents.y[i]) continue;
+                if (was) markEntity(drawnKind[i], drawnX[i] - dx, drawnY[i]);
+                if (now) markEntity(sim.ents.kind[i], sim.ents.x[i], sim.ents.y[i]);
+            }
+        }
+
+        drawnBirdY = sim.birdY;
+        drawnScore = sim.score;
+        drawnScrollTotal = scrollTotal();
+        rememberEntities();
+        scroller.set(drawnScrollTotal);
+        flush();
+        reportSpiStats();
     }
 
-    void drawSprite(int x, int y, const uint16_t *sprite, int w, int h) {
-        tft.pushImage(x, y, w, h, sprite);
+    // Tổng quãng nền đã trôi kể từ đầu ván
+    uint32_t scrollTotal() const {
+        return sim.tick * sim.scrollSpeed;
     }
 
-    void drawPipe(int x, int topH, uint16_t color) {
-        // Ống trên
-        tft.fillRect(x, 0, pipeWidth, topH, color);
-        tft.drawRect(x, 0, pipeWidth, topH, TFT_DARKGREEN);
-        // Ống dưới
-        tft.fillRect(x, topH + pipeGap, pipeWidth, SCREEN_H - (topH + pipeGap) - 16, color);
-        tft.drawRect(x, topH + pipeGap, pipeWidth, SCREEN_H - (topH + pipeGap) - 16, TFT_DARKGREEN);
+    // Đất trôi cùng tốc độ với ống; chỉ cần phần dư trong chu kỳ hoa văn
+    uint32_t groundScroll() const {
+        return scrollTotal() % FLAPPY_GROUND_PERIOD;
     }
 
-    void drawGround() {
-        tft.fillRect(0, SCREEN_H - 16, SCREEN_W, 16, TFT_BROWN);
-        tft.fillRect(0, SCREEN_H - 20, SCREEN_W, 4, TFT_GREEN);
+    void rememberEntities() {
+        drawnActive = sim.ents.active;
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            drawnX[i] = sim.ents.x[i];
+            drawnY[i] = sim.ents.y[i];
+            drawnKind[i] = sim.ents.kind[i];
+        }
+    }
+
+    // Ống chiếm cả cột (trừ đất), vật khác chỉ chiếm hộp của nó
+    void markEntity(uint8_t kind, int x, int y) {
+        if (kind == FLAPPY_PIPE) dirty.add(x, 0, sim.pipeWidth, groundTop());
+        else if (kind == FLAPPY_COIN) dirty.add(x, y, sim.coinSize, sim.coinSize);
+        else dirty.add(x, y, sim.moverSize, sim.moverSize);
+    }
+
+    // Ống dịch ngang ít hơn bề rộng: chỉ 2 mép trái/phải thay đổi
+    // (cả viền), phần thân ở giữa giữ nguyên màu.
+    void markPipeMoved(int oldX, int oldTop, int newX, int newTop) {
+        int groundY = groundTop();
+        int dx = oldX > newX ? oldX - newX : newX - oldX;
+
+        if (oldTop != newTop || dx >= sim.pipeWidth - 2) {
+            dirty.add(oldX, 0, sim.pipeWidth, groundY);
+            dirty.add(newX, 0, sim.pipeWidth, groundY);
+            return;
+        }
+
+        int left = oldX < newX ? oldX : newX;
+        int bottomY = newTop + sim.pipeGap;
+        // Mép trái và mép phải, mỗi mép tách phần ống trên / ống dưới
+        dirty.add(left, 0, dx + 1, newTop);
+        dirty.add(left, bottomY, dx + 1, groundY - bottomY);
+        dirty.add(left + sim.pipeWidth - 1, 0, dx + 1, newTop);
+        dirty.add(left + sim.pipeWidth - 1, bottomY, dx + 1, groundY - bottomY);
+    }
+
+    // Ghép cảnh của từng vùng thay đổi vào back-buffer rồi đẩy 1 lần,
+    // mỗi pixel lên màn hình đúng 1 lần nên không còn nhấp nháy
+    void flush() {
+        // Khi cuộn phần cứng, x logic nằm ở x + shift trong GRAM (quay vòng
+        // theo SCREEN_W): vùng vắt qua mép nối được tách làm 2
+        int shift = scroller.enabled() ? scroller.offset() : 0;
+        int seam = SCREEN_W - shift;
+
+        for (uint8_t i = 0; i < dirty.count(); i++) {
+            const DirtyRect& r = dirty[i];
+            if (r.x < seam && r.x + r.w > seam) {
+                DirtyRect left = { r.x, r.y, (int16_t)(seam - r.x), r.h };
+                DirtyRect right = { (int16_t)seam, r.y, (int16_t)(r.x + r.w - seam), r.h };
+                pushRect(left, shift);
+                pushRect(right, shift - SCREEN_W);
+            } else {
+                pushRect(r, r.x >= seam ? shift - SCREEN_W : shift);
+            }
+        }
+    }
+
+    // Ghép vùng r và đẩy lên màn hình ở x + shift
+    void pushRect(const DirtyRect &r, int shift) {
+        if (canvasH == 0) {
+            composeRect(tft, r, -shift, 0);
+            countSpi(r.w, r.h);
+            return;
+        }
+
+        // Dải ngang: ghép + đẩy từng phần của r nằm trong mỗi dải
+        for (int y = r.y; y < r.y + r.h;) {
+            int bandTop = y - y % canvasH;
+            int h = min(r.y + r.h, bandTop + canvasH) - y;
+            DirtyRect part = { r.x, (int16_t)y, r.w, (int16_t)h };
+            composeRect(canvas, part, 0, bandTop);
+            canvas.pushSprite(r.x + shift, y, r.x, y - bandTop, r.w, h);
+            countSpi(r.w, h);
+            y += h;
+        }
+    }
+
+    // Vẽ cảnh trong vùng clip lên dst, gốc toạ độ dst là (ox, oy)
+    void composeRect(TFT_eSPI &dst, const DirtyRect &clip, int ox, int oy) {
+        dst.setViewport(clip.x - ox, clip.y - oy, clip.w, clip.h, false);
+        dst.fillRect(clip.x - ox, clip.y - oy, clip.w, clip.h, TFT_CYAN);
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (sim.ents.isActive(i)) drawEntity(dst, i, clip, ox, oy);
+        }
+        if (clip.y + clip.h > groundTop()) drawGround(dst, clip, ox, oy);
+        dst.pushImage(sim.birdX - ox, sim.birdY - oy, BIRD_PX, BIRD_PX, birdPixels);
+        drawScore(dst, 5 - ox, 5 - oy);
+        dst.resetViewport();
+    }
+
+    // Chép khối tile (x, y, w, h) vào dst, cắt theo clip. row(r) = dòng tile
+    // cho hàng r của màn hình, bắt đầu từ cột x. Lên màn hình: 1 cửa sổ cho
+    // cả khối, gửi nguyên byte; vào sprite: memcpy thẳng bộ đệm.
+    template <class RowFn>
+    void blit(TFT_eSPI &dst, RowFn row, int x, int y, int w, int h,
+              const DirtyRect &clip, int ox, int oy) {
+        int x0 = max(x, (int)clip.x), x1 = min(x + w, clip.x + clip.w);
+        int y0 = max(y, (int)clip.y), y1 = min(y + h, clip.y + clip.h);
+        if (x0 >= x1 || y0 >= y1) return;
+
+        if (&dst == &canvas) {
+            uint16_t *buf = (uint16_t *)canvas.getPointer();
+            for (int r = y0; r < y1; r++) {
+                memcpy(&buf[(r - oy) * SCREEN_W + (x0 - ox)], row(r) + (x0 - x), (x1 - x0) * sizeof(uint16_t));
+            }
+            return;
+        }
+
+        bool swap = dst.getSwapBytes();
+        dst.setSwapBytes(false);
+        dst.startWrite();
+        dst.setAddrWindow(x0 - ox, y0 - oy, x1 - x0, y1 - y0);
+        for (int r = y0; r < y1; r++) dst.pushPixels(row(r) + (x0 - x), x1 - x0);
+        dst.endWrite();
+        dst.setSwapBytes(swap);
+    }
+
+    void drawScore(TFT_eSPI &dst, int x, int y) {
+        dst.setTextColor(TFT_WHITE, TFT_CYAN);
+        dst.setTextSize(2);
+        dst.setCursor(x, y);
+        dst.print(sim.score);
+    }
+
+    void drawEntity(TFT_eSPI &dst, uint8_t i, const DirtyRect &clip, int ox, int oy) {
+        int x = sim.ents.x[i] - ox, y = sim.ents.y[i] - oy, w = sim.ents.w[i], h = sim.ents.h[i];
+        switch (sim.ents.kind[i]) {
+        case FLAPPY_PIPE:
+            drawPipe(dst, sim.ents.x[i], sim.ents.y[i], clip, ox, oy);
+            break;
+        case FLAPPY_COIN:
+            dst.fillCircle(x + w / 2, y + h / 2, (w - 1) / 2, TFT_YELLOW);
+            break;
+        default:
+            dst.fillRect(x, y, w, h, TFT_RED);
+            dst.drawRect(x, y, w, h, TFT_MAROON);
+            break;
+        }
+    }
+
+    // Ống = dòng thân lặp lại + 1 dòng mép ở phía khe
+    void drawPipe(TFT_eSPI &dst, int x, int topH, const DirtyRect &clip, int ox, int oy) {
+        int botY = topH + sim.pipeGap;
+        int botH = sim.groundY - botY;
+        if (!tilesReady) {
+            dst.fillRect(x - ox, -oy, sim.pipeWidth, topH, TFT_GREEN);
+            dst.drawRect(x - ox, -oy, sim.pipeWidth, topH, TFT_DARKGREEN);
+            dst.fillRect(x - ox, botY - oy, sim.pipeWidth, botH, TFT_GREEN);
+            dst.drawRect(x - ox, botY - oy, sim.pipeWidth, botH, TFT_DARKGREEN);
+            return;
+        }
+        // Mỗi nửa ống (thân + mép phía khe) là 1 khối: 1 cửa sổ cho mỗi vùng
+        // bẩn. Ống dưới dừng ở mặt cỏ, phần bị đất che không gửi.
+        const uint16_t *body = tiles.pipeBody, *cap = tiles.pipeCap;
+        blit(dst, [=](int r) { return r == topH - 1 ? cap : body; },
+             x, 0, sim.pipeWidth, topH, clip, ox, oy);
+        blit(dst, [=](int r) { return r == botY ? cap : body; },
+             x, botY, sim.pipeWidth, groundTop() - botY, clip, ox, oy);
+    }
+
+    void drawGround(TFT_eSPI &dst, const DirtyRect &clip, int ox, int oy) {
+        int y = groundTop();
+        if (!tilesReady) {
+            dst.fillRect(-ox, sim.groundY - oy, SCREEN_W, SCREEN_H - sim.groundY, TFT_BROWN);
+            dst.fillRect(-ox, y - oy, SCREEN_W, FLAPPY_GRASS_H, TFT_GREEN);
+            return;
+        }
+        const uint16_t *rows = tiles.groundAt(groundScroll());
+        blit(dst, [=](int r) { return rows + (r - y) * (int)tiles.groundStride; },
+             0, y, SCREEN_W, tiles.groundH, clip, ox, oy);
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,317 @@
+#ifndef FLAPPY_SIM_H
+#define FLAPPY_SIM_H
+
+// Logic FlappyBird thuần (không phụ thuộc Arduino/màn hình): chạy được trên
+// máy host để replay, profile và fuzz va chạm. Kích thước sân chơi lấy từ
+// PanelView lúc biên dịch.
+
+#include <stdint.h>
+#include <math.h>
+#include "Panel.h"
+
+// Vật lý fixed-point Q24.8 (ESP32-C3 không có FPU: float bị giả lập bằng phần mềm).
+// So với float: test/test_flappy_fixed
+#define FLAPPY_FP_SHIFT 8
+#define FLAPPY_FP(x) ((int32_t)((x) * (1 << FLAPPY_FP_SHIFT)))
+
+// Kiểu số của vị trí/vận tốc chim, tham số Physics của FlappySim
+struct FlappyFixedPhysics {
+    typedef int32_t Value;
+    static constexpr Value fromPx(double px) { return FLAPPY_FP(px); }
+    static int toPx(Value v) { return v >> FLAPPY_FP_SHIFT; }
+};
+
+// Float như trước khi dùng fixed-point, chỉ để so trong test
+struct FlappyFloatPhysics {
+    typedef float Value;
+    static constexpr Value fromPx(double px) { return (float)px; }
+    static int toPx(Value v) { return (int)floorf(v); }
+};
+
+// PRNG xorshift32: cùng seed cho cùng dãy ống trên mọi máy
+struct FlappyRng {
+    uint32_t state = 1;
+
+    void seed(uint32_t s) { state = s ? s : 0x9E3779B9u; }
+
+    uint32_t next() {
+        uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return state = x;
+    }
+
+    // [lo, hi) như random(lo, hi) của Arduino
+    int32_t range(int32_t lo, int32_t hi) {
+        return hi > lo ? lo + (int32_t)(next() % (uint32_t)(hi - lo)) : lo;
+    }
+};
+
+// 1 mục nhật ký input: từ tick này trở đi nút ở trạng thái pressed
+struct FlappyInput {
+    uint32_t tick;
+    bool pressed;
+};
+
+// Nhật ký input, chỉ ghi khi trạng thái nút đổi
+template <uint16_t N>
+class FlappyInputLog {
+public:
+    void clear() {
+        n = 0;
+        last = false;
+        overflow = false;
+    }
+
+    void record(uint32_t tick, bool pressed) {
+        if (pressed == last) return;
+        last = pressed;
+        if (n >= N) {
+            overflow = true;
+            return;
+        }
+        entries[n].tick = tick;
+        entries[n].pressed = pressed;
+        n++;
+    }
+
+    uint16_t count() const { return n; }
+    bool overflowed() const { return overflow; }
+    const FlappyInput* data() const { return entries; }
+
+private:
+    FlappyInput entries[N];
+    uint16_t n = 0;
+    bool last = false;
+    bool overflow = false;
+};
+
+// Chim: sprite thiết kế 8x8 cho cao 160 px, thu/phóng theo FlappySim::scaled
+#define FLAPPY_BIRD_PX 8
+
+// Số entity tối đa cùng lúc (ống, xu, vật cản di động)
+#define FLAPPY_MAX_ENTITIES 8
+
+enum FlappyEntityKind : uint8_t {
+    FLAPPY_PIPE = 0,    // cột ống: y = đáy ống trên, h = khe hở
+    FLAPPY_COIN,        // ăn được +1 điểm
+    FLAPPY_MOVER        // vật cản trôi lên xuống
+};
+
+// Pool entity dạng struct-of-arrays, vòng lặp cố định FLAPPY_MAX_ENTITIES
+// nên chi phí mỗi tick không phụ thuộc số vật cản đang có.
+struct FlappyEntities {
+    uint16_t active = 0;            // bit i = slot i đang dùng
+    uint16_t passed = 0;            // bit i = ống i đã qua chim (đã cộng điểm)
+    int16_t x[FLAPPY_MAX_ENTITIES];
+    int16_t y[FLAPPY_MAX_ENTITIES];
+    int16_t w[FLAPPY_MAX_ENTITIES];
+    int16_t h[FLAPPY_MAX_ENTITIES];
+    int8_t vy[FLAPPY_MAX_ENTITIES];
+    uint8_t kind[FLAPPY_MAX_ENTITIES];
+
+    bool isActive(uint8_t i) const { return active & (1u << i); }
+
+    int spawn(FlappyEntityKind k, int16_t ex, int16_t ey, int16_t ew, int16_t eh, int8_t evy) {
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (isActive(i)) continue;
+            active |= 1u << i;
+            passed &= ~(1u << i);
+            kind[i] = k;
+            x[i] = ex;
+            y[i] = ey;
+            w[i] = ew;
+            h[i] = eh;
+            vy[i] = evy;
+            return i;
+        }
+        return -1;
+    }
+
+    void remove(uint8_t i) { active &= ~(1u << i); }
+};
+
+// Sân chơi = Screen::WIDTH x Screen::HEIGHT. Mọi kích thước dọc (chim, khe
+// ống, đất, xu, vật cản, lề sinh) và vật lý tỉ lệ theo chiều cao (mốc 160 px), nên
+// tỉ lệ chim/khe và thời gian 1 cú vỗ như nhau ở mọi hướng màn hình.
+template <class Screen, class Physics = FlappyFixedPhysics>
+class FlappySim {
+public:
+    // Màn hình
+    enum : int { SCREEN_W = Screen::WIDTH, SCREEN_H = Screen::HEIGHT };
+    const int groundY = SCREEN_H - scaled(16);  // đáy vùng bay (va chạm), mặt đất phía dưới
+
+    // Kích thước thiết kế cho cao 160 px -> px trên màn hình này (tối thiểu 1)
+    static constexpr int scaled(int px) {
+        return px * SCREEN_H / 160 > 0 ? px * SCREEN_H / 160 : 1;
+    }
+
+    // Chim
+    const int birdX = 20;
+    const int birdSize = scaled(FLAPPY_BIRD_PX);
+    typedef typename Physics::Value Value;
+    const Value gravity = Physics::fromPx(0.4) * SCREEN_H / 160;
+    const Value jumpStrength = Physics::fromPx(-4.5) * SCREEN_H / 160;
+    int birdY = 80;                 // pixel, = Physics::toPx(birdPos)
+    int prevBirdY = 80;             // vị trí đầu tick, cho va chạm quét
+    Value birdPos = Physics::fromPx(80);
+    Value velocity = 0;
+
+    // Ống và vật thể
+    const int pipeGap = scaled(45);
+    const int pipeWidth = 15;
+    const int pipeSpacing = 70;     // khoảng cách giữa 2 ống liên tiếp
+    const int scrollSpeed = 2;
+    const int coinSize = scaled(6);
+    const int moverSize = scaled(8);
+    const int spawnMargin = scaled(10);     // xu/vật cản cách mép trên và đất
+    FlappyEntities ents;
+    int spawnCountdown = 0;
+
+    // Game
+    bool gameOver = false;
+    int score = 0;
+    uint32_t tick = 0;              // số bước đã chạy kể từ reset
+
+    void reset(uint32_t seed) {
+        seedValue = seed;
+        rng.seed(seed);
+        birdY = prevBirdY = SCREEN_H / 2;
+        birdPos = Physics::fromPx(birdY);
+        velocity = 0;
+        ents.active = 0;
+        ents.passed = 0;
+        spawnCountdown = 0;
+        score = 0;
+        gameOver = false;
+        tick = 0;
+        spawnRow();
+    }
+
+    uint32_t seed() const { return seedValue; }
+
+    // Ống gần nhất chưa qua khỏi chim, -1 nếu không có
+    int nextPipe() const {
+        int best = -1;
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (!ents.isActive(i) || ents.kind[i] != FLAPPY_PIPE) continue;
+            if (ents.x[i] + ents.w[i] < birdX) continue;
+            if (best < 0 || ents.x[i] < ents.x[best]) best = i;
+        }
+        return best;
+    }
+
+    // 1 bước vật lý, flap = nút đang nhấn trong tick này
+    void step(bool flap) {
+        if (gameOver) return;
+        tick++;
+
+        // Nhảy
+        if (flap) velocity = jumpStrength;
+
+        // Cập nhật chim
+        prevBirdY = birdY;
+        velocity += gravity;
+        birdPos += velocity;
+        birdY = Physics::toPx(birdPos);
+
+        // Cập nhật entity
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (!ents.isActive(i)) continue;
+            ents.x[i] -= scrollSpeed;
+            if (ents.kind[i] == FLAPPY_MOVER) {
+                ents.y[i] += ents.vy[i];
+                if (ents.y[i] < 0 || ents.y[i] + ents.h[i] > groundY) {
+                    ents.vy[i] = -ents.vy[i];
+                    ents.y[i] += 2 * ents.vy[i];
+                }
+            }
+            if (ents.x[i] + ents.w[i] < 0) ents.remove(i);
+        }
+
+        spawnCountdown -= scrollSpeed;
+        if (spawnCountdown <= 0) spawnRow();
+
+        // Va chạm
+        if (birdY < 0 || birdY + birdSize > groundY) gameOver = true;
+        collide();
+    }
+
+private:
+    FlappyRng rng;
+    uint32_t seedValue = 0;
+
+    // Sinh 1 ống ở mép phải, thỉnh thoảng kèm xu hoặc vật cản giữa 2 ống
+    void spawnRow() {
+        spawnCountdown += pipeSpacing;
+        int16_t top = rng.range(SCREEN_H / 8, groundY - pipeGap - scaled(4));
+        ents.spawn(FLAPPY_PIPE, SCREEN_W, top, pipeWidth, pipeGap, 0);
+
+        uint32_t r = rng.next() % 6;
+        int16_t midX = SCREEN_W + pipeWidth + (pipeSpacing - pipeWidth) / 2;
+        if (r < 2) {
+            ents.spawn(FLAPPY_COIN, midX - coinSize / 2, rng.range(spawnMargin, groundY - spawnMargin - coinSize),
+                       coinSize, coinSize, 0);
+        } else if (r == 2) {
+            ents.spawn(FLAPPY_MOVER, midX - moverSize / 2, rng.range(spawnMargin, groundY - spawnMargin - moverSize),
+                       moverSize, moverSize, (rng.next() & 1) ? 1 : -1);
+        }
+    }
+
+    // Va chạm quét: chim quét dọc từ prevBirdY tới birdY, entity quét ngang
+    // scrollSpeed px trong tick, nên vật nhanh/ống mỏng không bị xuyên qua.
+    void collide() {
+        int sweepTop = prevBirdY < birdY ? prevBirdY : birdY;
+        int sweepBottom = (prevBirdY > birdY ? prevBirdY : birdY) + birdSize;
+
+        for (uint8_t i = 0; i < FLAPPY_MAX_ENTITIES; i++) {
+            if (!ents.isActive(i)) continue;
+            int left = ents.x[i];
+            int right = ents.x[i] + ents.w[i] + scrollSpeed;
+            if (right <= birdX || left >= birdX + birdSize) {
+                // Ống đã qua hẳn chim: cộng điểm 1 lần
+                if (ents.kind[i] == FLAPPY_PIPE && right <= birdX && !(ents.passed & (1u << i))) {
+                    ents.passed |= 1u << i;
+                    score++;
+                }
+                continue;
+            }
+
+            if (ents.kind[i] == FLAPPY_PIPE) {
+                if (sweepTop < ents.y[i] || sweepBottom > ents.y[i] + ents.h[i]) gameOver = true;
+            } else if (sweepBottom > ents.y[i] && sweepTop < ents.y[i] + ents.h[i]) {
+                if (ents.kind[i] == FLAPPY_COIN) {
+                    score++;
+                    ents.remove(i);
+                } else {
+                    gameOver = true;
+                }
+            }
+        }
+    }
+};
+
+struct FlappyReplayResult {
+    uint32_t ticks;
+    int score;
+    bool gameOver;
+};
+
+// Chạy lại 1 ván từ seed + nhật ký input, không vẽ, nhanh nhất có thể
+template <class Screen, class Physics>
+FlappyReplayResult flappyReplay(FlappySim<Screen, Physics>& sim, uint32_t seed,
+                                       const FlappyInput* log, uint16_t count,
+                                       uint32_t maxTicks) {
+    sim.reset(seed);
+    uint16_t i = 0;
+    bool pressed = false;
+    while (!sim.gameOver && sim.tick < maxTicks) {
+        while (i < count && log[i].tick <= sim.tick) pressed = log[i++].pressed;
+        sim.step(pressed);
+    }
+    FlappyReplayResult r = { sim.tick, sim.score, sim.gameOver };
+    return r;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FLAPPY_TILES_H
+#define FLAPPY_TILES_H
+
+#include <TFT_eSPI.h>
+#include "Panel.h"
+
+// Tile RGB565 dựng sẵn 1 lần cho ống và đất: vẽ chỉ còn là chép dòng,
+// không phải fillRect/drawRect từng phần mỗi frame. Tile luôn ở thứ tự byte
+// của panel (big-endian, như bộ đệm TFT_eSprite 16-bit): chép thẳng vào
+// sprite bằng memcpy, hoặc đẩy nguyên byte lên màn hình khi swapBytes tắt.
+#define FLAPPY_TILE_MAX_W 32        // bề rộng ống tối đa
+#define FLAPPY_GRASS_H 4            // dòng cỏ trên cùng của đất, phần còn lại là đất
+#define FLAPPY_GROUND_PERIOD 8      // chu kỳ hoa văn đất, đất cuộn bằng offset trong chu kỳ
+
+#define FLAPPY_DARKBROWN 0x6180
+#define FLAPPY_DARKGRASS 0x0540
+
+// Screen: PanelView của sân chơi, đất phủ hết bề ngang Screen::WIDTH
+template <class Screen>
+struct FlappyTiles {
+    enum : int { groundStride = Screen::WIDTH + FLAPPY_GROUND_PERIOD };
+
+    uint16_t pipeBody[FLAPPY_TILE_MAX_W];   // viền | thân | viền
+    uint16_t pipeCap[FLAPPY_TILE_MAX_W];    // mép ống, toàn viền
+    uint16_t* ground = nullptr;             // groundH dòng x groundStride
+    int groundH = 0;
+    int scrollRow = 0;                      // dòng đầu tiên của đất đổi khi cuộn
+
+    ~FlappyTiles() { free(ground); }
+
+    // groundHeight: cỏ + đất, từ mặt cỏ tới đáy màn hình.
+    // Trả về false nếu không đủ RAM cho tile đất
+    bool build(int pipeWidth, int groundHeight) {
+        if (pipeWidth > FLAPPY_TILE_MAX_W) pipeWidth = FLAPPY_TILE_MAX_W;
+        for (int x = 0; x < pipeWidth; x++) {
+            bool edge = x == 0 || x == pipeWidth - 1;
+            pipeBody[x] = color(edge ? TFT_DARKGREEN : TFT_GREEN);
+            pipeCap[x] = color(TFT_DARKGREEN);
+        }
+
+        free(ground);
+        groundH = groundHeight;
+        ground = (uint16_t*)malloc(groundH * groundStride * sizeof(uint16_t));
+        if (!ground) return false;
+
+        for (int y = 0; y < groundH; y++) {
+            for (int x = 0; x < groundStride; x++) {
+                uint16_t c;
+                if (y < FLAPPY_GRASS_H) c = (y == FLAPPY_GRASS_H - 1 && (x & 4)) ? FLAPPY_DARKGRASS : TFT_GREEN;
+                else c = ((x + y) % FLAPPY_GROUND_PERIOD < 2) ? FLAPPY_DARKBROWN : TFT_BROWN;
+                ground[y * groundStride + x] = color(c);
+            }
+        }
+
+        // Dòng cỏ màu trơn giống nhau ở mọi offset cuộn
+        scrollRow = 0;
+        while (scrollRow < groundH && rowIsFlat(scrollRow)) scrollRow++;
+        return true;
+    }
+
+    // Dòng đầu của đất khi đã cuộn scroll px
+    const uint16_t* groundAt(uint32_t scroll) const {
+        return &ground[scroll % FLAPPY_GROUND_PERIOD];
+    }
+
+    bool rowIsFlat(int y) const {
+        for (int x = 1; x < FLAPPY_GROUND_PERIOD; x++) {
+            if (ground[y * groundStride + x] != ground[y * groundStride]) return false;
+        }
+        return true;
+    }
+
+    static uint16_t color(uint16_t c) {
+        return (uint16_t)((c >> 8) | (c << 8));
+    }
+};
+
+#endif
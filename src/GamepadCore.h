@@ -0,0 +1,156 @@
+#ifndef GAMEPAD_CORE_H
+#define GAMEPAD_CORE_H
+
+// Logic tay cầm tách khỏi phần cứng: snapshot của InputService -> gom
+// report -> GamepadReporter. Không phụ thuộc Arduino/BLE: firmware nối nó với
+// BleGamepad, máy host nối với bộ ghi report để giả lập.
+
+#include <stdint.h>
+#include "InputService.h"
+#include "Latency.h"
+#include "BitMask.h"
+
+#define GAMEPAD_MAX_BUTTONS INPUT_MAX_BUTTONS
+#define GAMEPAD_BATCH_SAMPLES 8
+
+// Nơi nhận report: BleGamepad trên thiết bị, bộ ghi trên máy host
+class GamepadReporter {
+public:
+    virtual ~GamepadReporter() {}
+    virtual bool isConnected() = 0;
+    virtual void press(uint8_t button) = 0;         // nút số 1..N
+    virtual void release(uint8_t button) = 0;
+    virtual void setAxis(uint8_t axis, int16_t value) = 0;
+    // Gửi report đang gom lúc nowUs, trả về thời điểm report đã giao đi
+    virtual uint32_t sendReport(uint32_t nowUs) = 0;
+    // 1 thay đổi có cạnh thật sắp vào report (cho đo trễ từng chặng)
+    virtual void timedChange(uint32_t edgeUs, uint32_t acceptUs) { (void)edgeUs; (void)acceptUs; }
+};
+
+class GamepadCore {
+public:
+    GamepadCore(GamepadReporter& r, InputService& in) : out(r), input(in) {}
+
+    // Gọi sau input.begin(): trạng thái khởi động coi như đã gửi
+    void begin() {
+        reported = input.state();
+        batchChanged = 0;
+        deferred = 0;
+        batchCount = 0;
+        axesChanged = false;
+        sentAny = false;
+    }
+
+    // Khoảng kết nối BLE: tối đa 1 report mỗi sự kiện kết nối, thay đổi đến
+    // sớm hơn được gom vào report kế tiếp. 0 = gửi ngay mỗi lượt.
+    void setReportInterval(uint32_t us) { intervalUs = us; }
+
+    void setAxis(uint8_t axis, int16_t value) {
+        out.setAxis(axis, value);
+        axesChanged = true;
+    }
+
+    // 1 lượt: đưa phần snapshot khác host vào report đang gom, gửi khi đã
+    // qua 1 khoảng kết nối từ report trước. Nhấn-nhả gọn trong 1 lượt vẫn được
+    // gửi đủ 2 report. Trả về true nếu có input mới (hoạt động người chơi).
+    bool update(const InputSnapshot& snap) {
+        bool active = axesChanged;
+        uint64_t diff = (snap.state ^ reported) & buttonMask();
+        // Nút đã đổi rồi đổi lại trong lúc bị hoãn cũng là 1 cú nhấn-nhả
+        uint64_t taps = ((snap.pressed & snap.released) | deferred) & ~diff & buttonMask();
+        deferred = 0;
+        if (out.isConnected() && (diff | taps)) {
+            active = true;
+            forEachBit(taps, [&](uint8_t i) {
+                setButton(i, !snap.held(i), snap.timeUs, false);
+            });
+            forEachBit(diff | taps, [&](uint8_t i) {
+                setButton(i, snap.held(i), snap.timeUs, snap.fresh & (1ULL << i));
+            });
+        }
+        if (due(snap.timeUs)) flush(snap.timeUs);
+        return active;
+    }
+
+    // Micro giây tới lúc report đang gom được gửi, DEBOUNCE_NEVER nếu không có gì chờ
+    uint32_t nextWaitUs(uint32_t now) const {
+        if (!batchChanged && !axesChanged) return DEBOUNCE_NEVER;
+        return due(now) ? 0 : lastSentUs + intervalUs - now;
+    }
+
+    // Thống kê
+    const LatencyHistogram& latency() const { return btnLatency; }  // cạnh -> report giao đi
+    uint32_t reports() const { return reportsSent; }
+    uint32_t changes() const { return changesSent; }                // số lần đổi nút đã gửi
+
+private:
+    GamepadReporter& out;
+    InputService& input;
+    uint64_t reported = 0;          // trạng thái đã gửi cho host
+
+    // Report đang gom của lượt hiện tại
+    uint64_t batchChanged = 0;      // bit i = nút i đã đổi trong report đang gom
+    uint64_t deferred = 0;          // bit i = lần đổi thứ 2 của nút i chờ report sau
+    uint32_t batchTime[GAMEPAD_BATCH_SAMPLES];
+    uint8_t batchCount = 0;
+    bool axesChanged = false;
+
+    uint32_t intervalUs = 0;
+    uint32_t lastSentUs = 0;
+    bool sentAny = false;
+
+    LatencyHistogram btnLatency;
+    uint32_t reportsSent = 0;
+    uint32_t changesSent = 0;
+
+    uint64_t buttonMask() const {
+        uint8_t n = input.count();
+        return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+    }
+
+    // Đã qua 1 khoảng kết nối kể từ report trước
+    bool due(uint32_t now) const {
+        return !sentAny || (int32_t)(now - lastSentUs) >= (int32_t)intervalUs;
+    }
+
+    void flush(uint32_t now) {
+        if (!batchChanged && !axesChanged) return;
+        uint32_t sent = out.sendReport(now);
+        lastSentUs = sent;
+        sentAny = true;
+        for (uint8_t i = 0; i < batchCount; i++) btnLatency.add(sent - batchTime[i]);
+        reportsSent++;
+        batchChanged = 0;
+        batchCount = 0;
+        axesChanged = false;
+    }
+
+    // Đưa trạng thái của nút i vào report; timed = có cạnh thật để đo trễ
+    void setButton(uint8_t i, bool pressed, uint32_t now, bool timed) {
+        uint64_t bit = 1ULL << i;
+
+        // Nút đã đổi trong report đang gom: gửi report đó trước để host không
+        // mất cú nhấn, chưa tới sự kiện kết nối kế tiếp thì hoãn sang lượt sau
+        if (batchChanged & bit) {
+            if (!due(now)) {
+                deferred |= bit;
+                return;
+            }
+            flush(now);
+        }
+        batchChanged |= bit;
+
+        if (pressed) reported |= bit;
+        else         reported &= ~bit;
+        if (pressed) out.press(i + 1);
+        else         out.release(i + 1);
+        changesSent++;
+
+        if (!timed) return;
+        uint32_t edgeUs = input.edgeTime(i);
+        if (batchCount < GAMEPAD_BATCH_SAMPLES) batchTime[batchCount++] = edgeUs;
+        out.timedChange(edgeUs, input.acceptTime(i));
+    }
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef GAMEPAD_POWER_H
+#define GAMEPAD_POWER_H
+
+#include <Arduino.h>
+#include <NimBLEDevice.h>
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+#include <sys/time.h>
+
+// Tiết kiệm pin cho tay cầm:
+//  - light sleep tự động khi CPU rảnh (cần sdkconfig có CONFIG_PM_ENABLE và
+//    CONFIG_FREERTOS_USE_TICKLESS_IDLE; không có thì chỉ hạ xung nhịp),
+//  - deep sleep khi mất kết nối quá lâu, nút 1 đánh thức, quảng bá nhanh
+//    một lúc sau khi thức để host nối lại sớm.
+#define POWER_DEEP_SLEEP_MS 300000  // mất kết nối bao lâu thì deep sleep
+#define POWER_FAST_ADV_MS 30000     // quảng bá nhanh sau khi thức dậy
+#define POWER_FAST_ADV_MIN 32       // 20ms (đơn vị 0.625ms)
+#define POWER_FAST_ADV_MAX 48       // 30ms
+#define POWER_SLOW_ADV_MIN 160      // 100ms
+#define POWER_SLOW_ADV_MAX 240      // 150ms
+#define POWER_MIN_FREQ_MHZ 40
+
+// Dòng tiêu thụ ước lượng từng trạng thái (mA), chỉnh theo đo thực tế của board
+#define POWER_MA_AWAKE 30.0f        // CPU chạy, radio bật
+#define POWER_MA_IDLE 3.0f          // chờ trong light sleep, giữ kết nối BLE
+#define POWER_MA_DEEP 0.01f
+
+// Giữ qua deep sleep
+RTC_DATA_ATTR static uint64_t powerDeepUs = 0;      // tổng thời gian đã deep sleep
+RTC_DATA_ATTR static uint64_t powerAwakeUs = 0;     // của các lần thức trước
+RTC_DATA_ATTR static uint64_t powerIdleUs = 0;
+RTC_DATA_ATTR static int64_t powerSleptAt = 0;      // giờ hệ thống (chạy tiếp qua deep sleep) lúc ngủ
+RTC_DATA_ATTR static uint32_t powerDeepSleeps = 0;
+
+class GamepadPower {
+public:
+    // Gọi đầu setup(). Trả về true nếu vừa thức dậy từ deep sleep.
+    bool begin() {
+        woke = esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED;
+        if (woke && powerSleptAt) {
+            powerDeepUs += systemUs() - powerSleptAt;
+            powerDeepSleeps++;
+        } else {
+            powerDeepUs = powerAwakeUs = powerIdleUs = 0;
+            powerDeepSleeps = 0;
+        }
+
+#if CONFIG_IDF_TARGET_ESP32C3
+        esp_pm_config_esp32c3_t pm;
+#else
+        esp_pm_config_esp32_t pm;
+#endif
+        pm.max_freq_mhz = getCpuFrequencyMhz();
+        pm.min_freq_mhz = POWER_MIN_FREQ_MHZ;
+        pm.light_sleep_enable = true;
+        esp_err_t err = esp_pm_configure(&pm);
+        if (err != ESP_OK) {
+            pm.light_sleep_enable = false;
+            err = esp_pm_configure(&pm);
+        }
+        lightSleep = err == ESP_OK && pm.light_sleep_enable;
+        Serial.printf("power: pm %s, light sleep %s\n", err == ESP_OK ? "on" : esp_err_to_name(err),
+                      lightSleep ? "auto" : "off");
+        return woke;
+    }
+
+    // Thời gian loop đã chờ (CPU rảnh, có thể light sleep)
+    void idle(uint32_t us) { idleUs += us; }
+
+    // Gọi mỗi vòng loop. wakePin: chân đánh thức deep sleep (nhấn = LOW).
+    void update(uint32_t nowMs, bool connected, int wakePin) {
+        if (connected) {
+            disconnectedAt = nowMs;
+            if (advMode != ADV_DONE) {
+                // Lần quảng bá lại sau khi mất kết nối dùng chu kỳ chậm
+                NimBLEAdvertising* adv = NimBLEDevice::getAdvertising();
+                if (adv) {
+                    adv->setMinInterval(POWER_SLOW_ADV_MIN);
+                    adv->setMaxInterval(POWER_SLOW_ADV_MAX);
+                }
+                advMode = ADV_DONE;
+            }
+            return;
+        }
+        // BleGamepad bật quảng bá trong task riêng: đợi nó chạy rồi mới đổi chu kỳ
+        if (advMode == ADV_PENDING) {
+            setAdvertising(woke && nowMs < POWER_FAST_ADV_MS);
+        } else if (advMode == ADV_FAST && nowMs >= POWER_FAST_ADV_MS) {
+            setAdvertising(false);
+        }
+        if (nowMs - disconnectedAt >= POWER_DEEP_SLEEP_MS) deepSleep(wakePin);
+    }
+
+    // Gọi sau mỗi report gửi đi: report đầu tiên sau khi thức đo trễ thức -> report
+    void reportSent() {
+        if (!woke || wakeToReportUs) return;
+        wakeToReportUs = esp_timer_get_time();
+        Serial.printf("power: wake->first report %lu ms\n", (unsigned long)(wakeToReportUs / 1000));
+    }
+
+    // Dòng trung bình ước lượng theo tỉ lệ thời gian từng trạng thái
+    void print() const {
+        uint64_t now = esp_timer_get_time();
+        uint64_t idleTotal = powerIdleUs + idleUs;
+        uint64_t awakeTotal = powerAwakeUs + now - idleUs;
+        uint64_t total = awakeTotal + idleTotal + powerDeepUs;
+        if (total == 0) return;
+        float fAwake = (float)awakeTotal / total;
+        float fIdle = (float)idleTotal / total;
+        float fDeep = (float)powerDeepUs / total;
+        float mA = fAwake * POWER_MA_AWAKE + fIdle * (lightSleep ? POWER_MA_IDLE : POWER_MA_AWAKE)
+                 + fDeep * POWER_MA_DEEP;
+        Serial.printf("power: awake %.1f%% idle %.1f%% deep %.1f%% (%lu sleeps) ~%.2f mA\n",
+                      fAwake * 100, fIdle * 100, fDeep * 100, (unsigned long)powerDeepSleeps, mA);
+    }
+
+private:
+    bool woke = false;
+    bool lightSleep = false;
+    enum AdvMode : uint8_t { ADV_PENDING, ADV_FAST, ADV_SLOW, ADV_DONE };
+    AdvMode advMode = ADV_PENDING;
+    uint64_t idleUs = 0;
+    uint32_t disconnectedAt = 0;
+    int64_t wakeToReportUs = 0;
+
+    void setAdvertising(bool fast) {
+        NimBLEAdvertising* adv = NimBLEDevice::getAdvertising();
+        if (!adv || !adv->isAdvertising()) return;
+        adv->stop();
+        adv->setMinInterval(fast ? POWER_FAST_ADV_MIN : POWER_SLOW_ADV_MIN);
+        adv->setMaxInterval(fast ? POWER_FAST_ADV_MAX : POWER_SLOW_ADV_MAX);
+        adv->start();
+        advMode = fast ? ADV_FAST : ADV_SLOW;
+    }
+
+    static int64_t systemUs() {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+    }
+
+    void deepSleep(int wakePin) {
+        Serial.println("power: deep sleep");
+        Serial.flush();
+        powerIdleUs += idleUs;
+        powerAwakeUs += esp_timer_get_time() - idleUs;
+        powerSleptAt = systemUs();
+        gpio_num_t pin = (gpio_num_t)wakePin;
+#if CONFIG_IDF_TARGET_ESP32C3
+        // C3: chỉ GPIO0..5 đánh thức được deep sleep
+        gpio_pullup_en(pin);
+        gpio_hold_en(pin);
+        gpio_deep_sleep_hold_en();
+        esp_deep_sleep_enable_gpio_wakeup(1ULL << wakePin, ESP_GPIO_WAKEUP_GPIO_LOW);
+#else
+        rtc_gpio_pullup_en(pin);
+        rtc_gpio_pulldown_dis(pin);
+        esp_sleep_enable_ext0_wakeup(pin, 0);
+#endif
+        esp_deep_sleep_start();
+    }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef GAMEPAD_SIM_H
+#define GAMEPAD_SIM_H
+
+// Giả lập tay cầm trên máy host: chạy InputService + GamepadCore với chuỗi cạnh GPIO kịch
+// bản, report được ghi lại kèm thời điểm thay cho BleGamepad. Đo số report,
+// hiệu quả gom (số thay đổi / report) và trễ giả lập tới lúc lên sóng.
+// Kịch bản kiểm tra: test/test_gamepad_sim (pio test -e native).
+
+#include "GamepadCore.h"
+
+struct GamepadSimReport {
+    uint32_t sentUs;            // lúc sendReport trả về
+    uint32_t airUs;             // sự kiện kết nối BLE kế tiếp: report lên sóng
+    uint64_t buttons;           // bit i = nút i+1 đang nhấn
+};
+
+// Đứng thay BleGamepad: giữ trạng thái report, ghi tối đa N report
+template <uint16_t N>
+class GamepadRecorder : public GamepadReporter {
+public:
+    bool connected = true;
+    uint32_t connIntervalUs = 7500;     // khoảng kết nối BLE giả lập
+    uint32_t stackUs = 150;             // thời gian trong sendReport (notify vào stack)
+    LatencyHistogram airLatency;        // cạnh -> lên sóng
+
+    bool isConnected() override { return connected; }
+    void press(uint8_t button) override { buttons |= 1ULL << (button - 1); }
+    void release(uint8_t button) override { buttons &= ~(1ULL << (button - 1)); }
+    void setAxis(uint8_t axis, int16_t value) override {
+        if (axis < 8) axes[axis] = value;
+    }
+
+    uint32_t sendReport(uint32_t nowUs) override {
+        uint32_t sent = nowUs + stackUs;
+        uint32_t air = connIntervalUs ? (sent / connIntervalUs + 1) * connIntervalUs : sent;
+        for (uint8_t i = 0; i < numEdges; i++) airLatency.add(air - edges[i]);
+        numEdges = 0;
+        if (n < N) {
+            log[n].sentUs = sent;
+            log[n].airUs = air;
+            log[n].buttons = buttons;
+            n++;
+        } else {
+            overflow = true;
+        }
+        total++;
+        return sent;
+    }
+
+    void timedChange(uint32_t edgeUs, uint32_t acceptUs) override {
+        (void)acceptUs;
+        if (numEdges < GAMEPAD_BATCH_SAMPLES) edges[numEdges++] = edgeUs;
+    }
+
+    uint16_t count() const { return n; }
+    uint32_t reports() const { return total; }
+    bool overflowed() const { return overflow; }
+    const GamepadSimReport* data() const { return log; }
+    int16_t axis(uint8_t i) const { return axes[i]; }
+
+private:
+    GamepadSimReport log[N];
+    uint16_t n = 0;
+    uint32_t total = 0;
+    bool overflow = false;
+    uint64_t buttons = 0;
+    int16_t axes[8] = {0};
+    uint32_t edges[GAMEPAD_BATCH_SAMPLES];
+    uint8_t numEdges = 0;
+};
+
+// 1 cạnh GPIO trong kịch bản (phải tăng dần theo thời gian)
+struct GpioTraceEdge {
+    uint32_t timeUs;
+    uint8_t button;             // chỉ số nút 0..
+    bool pressed;
+};
+
+// Dựng kịch bản: nhấn giữ có dội phím ở cả 2 đầu
+template <uint16_t N>
+class GpioTrace {
+public:
+    // 1 lần nhấn nút lúc t, giữ holdUs, mỗi đầu dội `bounces` lần cách nhau gapUs.
+    // Các cạnh được chèn đúng thứ tự thời gian.
+    void tap(uint8_t button, uint32_t t, uint32_t holdUs, uint8_t bounces = 0, uint32_t gapUs = 200) {
+        burst(button, t, true, bounces, gapUs);
+        burst(button, t + holdUs, false, bounces, gapUs);
+    }
+
+    uint16_t count() const { return n; }
+    const GpioTraceEdge* data() const { return edges; }
+
+private:
+    GpioTraceEdge edges[N];
+    uint16_t n = 0;
+
+    void burst(uint8_t button, uint32_t t, bool level, uint8_t bounces, uint32_t gapUs) {
+        for (uint8_t b = 0; b <= 2 * bounces; b++) {
+            add(t + b * gapUs, button, (b & 1) ? !level : level);
+        }
+    }
+
+    void add(uint32_t t, uint8_t button, bool pressed) {
+        if (n >= N) return;
+        uint16_t i = n++;
+        while (i > 0 && edges[i - 1].timeUs > t) {
+            edges[i] = edges[i - 1];
+            i--;
+        }
+        edges[i].timeUs = t;
+        edges[i].button = button;
+        edges[i].pressed = pressed;
+    }
+};
+
+struct GamepadSimConfig {
+    uint8_t buttons;
+    DebounceConfig debounce;
+    uint32_t pollUs;            // 0 = đánh thức bằng ngắt; > 0 = quét định kỳ kiểu delay(5)
+    uint32_t wakeUs;            // ngắt -> loop chạy (đổi task)
+    uint32_t idleUs;            // chờ tối đa khi không có gì (IDLE_WAIT_MS)
+};
+
+struct GamepadSimResult {
+    uint32_t edges;
+    uint32_t changes;           // số lần đổi nút đã gửi
+    uint32_t reports;
+    uint32_t wakeups;           // số lượt loop
+    uint32_t bounces;
+    float changesPerReport;     // hiệu quả gom report
+    LatencyHistogram toStack;   // cạnh -> sendReport trả về
+};
+
+// Chạy loop giả lập giống firmware: chờ ngắt/hạn chót chống dội/lượt gửi
+// report kế tiếp (làm tròn lên ms như ulTaskNotifyTake) hoặc quét định kỳ,
+// rồi update 1 lượt.
+template <uint16_t N>
+inline GamepadSimResult gamepadSimulate(const GamepadSimConfig& cfg, const GpioTraceEdge* trace,
+                                        uint16_t count, uint32_t endUs, GamepadRecorder<N>& rec) {
+    InputService input;
+    input.begin(cfg.buttons, &cfg.debounce, true, 0, 0);
+    GamepadCore core(rec, input);
+    core.begin();
+    core.setReportInterval(rec.connIntervalUs);
+
+    GamepadSimResult r = {};
+    r.edges = count;
+    uint32_t now = 0;
+    uint16_t i = 0;
+    while (true) {
+        uint32_t next;
+        if (cfg.pollUs) {
+            next = now + cfg.pollUs;
+        } else {
+            uint32_t waitUs = input.nextWaitUs(now);
+            uint32_t reportUs = core.nextWaitUs(now);
+            if (reportUs < waitUs) waitUs = reportUs;
+            uint32_t wait = waitUs == DEBOUNCE_NEVER ? cfg.idleUs : (waitUs + 999) / 1000 * 1000;
+            if (wait > cfg.idleUs) wait = cfg.idleUs;
+            next = now + wait;
+            if (i < count && trace[i].timeUs + cfg.wakeUs < next) next = trace[i].timeUs + cfg.wakeUs;
+        }
+        if (next > endUs) break;
+        now = next;
+        r.wakeups++;
+
+        // ISR đã đóng dấu mọi cạnh tới thời điểm này
+        while (i < count && trace[i].timeUs <= now) {
+            input.edge(trace[i].button, trace[i].pressed, trace[i].timeUs);
+            i++;
+        }
+        core.update(input.sample(now));
+    }
+
+    r.changes = core.changes();
+    r.reports = core.reports();
+    r.bounces = input.bounces();
+    r.changesPerReport = r.reports ? (float)r.changes / r.reports : 0;
+    r.toStack = core.latency();
+    return r;
+}
+
+#endif
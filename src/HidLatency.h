@@ -0,0 +1,82 @@
+#ifndef HID_LATENCY_H
+#define HID_LATENCY_H
+
+#include <Arduino.h>
+#include "Latency.h"
+
+// Đo trễ từng chặng từ cạnh GPIO tới lúc report HID được giao cho BLE stack:
+//   cạnh -> chống dội nhận -> gọi sendReport -> sendReport trả về
+// NimBLE không báo lúc notify thực sự lên sóng, nên chặng cuối dừng ở
+// stack; phần còn lại tối đa 1 khoảng kết nối.
+// Lệnh qua Serial: 'l' in histogram, 'c' xoá.
+enum HidLatencyStage : uint8_t {
+    HID_STAGE_DEBOUNCE = 0,     // cạnh -> chống dội nhận
+    HID_STAGE_QUEUE,            // nhận -> gọi sendReport (gom report, chờ lượt)
+    HID_STAGE_NOTIFY,           // thời gian trong sendReport (notify vào stack)
+    HID_STAGE_TOTAL,            // cạnh -> sendReport trả về
+    HID_STAGE_COUNT
+};
+
+#define HID_LATENCY_BATCH 8
+
+class HidLatency {
+public:
+    // 1 nút đổi trong report đang gom
+    void addEdge(uint32_t edgeUs, uint32_t acceptUs) {
+        if (count >= HID_LATENCY_BATCH) return;
+        edges[count] = edgeUs;
+        accepts[count] = acceptUs;
+        count++;
+    }
+
+    // Ngay trước và ngay sau sendReport()
+    void queued(uint32_t t) { queuedAt = t; }
+    void sent(uint32_t t) {
+        if (count == 0) return;
+        stages[HID_STAGE_NOTIFY].add(t - queuedAt);
+        for (uint8_t i = 0; i < count; i++) {
+            stages[HID_STAGE_DEBOUNCE].add(accepts[i] - edges[i]);
+            stages[HID_STAGE_QUEUE].add(queuedAt - accepts[i]);
+            stages[HID_STAGE_TOTAL].add(t - edges[i]);
+        }
+        count = 0;
+    }
+
+    void clear() {
+        for (uint8_t s = 0; s < HID_STAGE_COUNT; s++) stages[s].clear();
+        count = 0;
+    }
+
+    void print() const {
+        static const char* const names[HID_STAGE_COUNT] = {
+            "edge->debounce", "debounce->queue", "queue->notify", "edge->notify"
+        };
+        for (uint8_t s = 0; s < HID_STAGE_COUNT; s++) {
+            const LatencyHistogram& h = stages[s];
+            Serial.printf("%-16s n=%lu p50=%luus p90=%luus p99=%luus max=%luus\n", names[s],
+                          (unsigned long)h.count(), (unsigned long)h.median(), (unsigned long)h.percentile(90),
+                          (unsigned long)h.percentile(99), (unsigned long)h.worst());
+        }
+    }
+
+    // Đọc lệnh Serial, gọi trong loop
+    void poll() {
+        while (Serial.available()) {
+            int c = Serial.read();
+            if (c == 'l') print();
+            else if (c == 'c') {
+                clear();
+                Serial.println("latency cleared");
+            }
+        }
+    }
+
+private:
+    LatencyHistogram stages[HID_STAGE_COUNT];
+    uint32_t edges[HID_LATENCY_BATCH];
+    uint32_t accepts[HID_LATENCY_BATCH];
+    uint8_t count = 0;
+    uint32_t queuedAt = 0;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef HW_SCROLL_H
+#define HW_SCROLL_H
+
+#include <TFT_eSPI.h>
+#include "Panel.h"
+
+// Cuộn phần cứng của ST7735 (VSCRDEF 0x33 / VSCRSADD 0x37). Thanh ghi cuộn
+// chạy theo trục dọc gốc của panel, nên ở chiều ngang (Screen::LANDSCAPE)
+// nó thành cuộn ngang. Vùng cố định đầu = dòng lệch ROW_START của panel
+// (80x160: dòng 1..160 của GRAM 162 dòng).
+//
+// Ở rotation có lật trục (MY) nội dung chạy ngược chiều thanh ghi.
+// Định nghĩa HWSCROLL_INVERT nếu panel cuộn sai chiều.
+template <class Screen>
+class HwScroll {
+public:
+    explicit HwScroll(TFT_eSPI &display) : tft(display) {}
+
+    // Bật cho vùng cuộn dài `length` px. Chỉ hỗ trợ ST7735 ở chiều ngang.
+    bool begin(int length) {
+#ifdef ST7735_DRIVER
+        if (!Screen::LANDSCAPE || length != Screen::WIDTH) return false;
+        span = length;
+        invert = (Screen::ROTATION == 3);
+#ifdef HWSCROLL_INVERT
+        invert = !invert;
+#endif
+        int bfa = GRAM_LINES - TFA - span;
+        tft.writecommand(0x33);     // VSCRDEF
+        tft.writedata(0);
+        tft.writedata(TFA);
+        tft.writedata(span >> 8);
+        tft.writedata(span & 0xFF);
+        tft.writedata(bfa >> 8);
+        tft.writedata(bfa & 0xFF);
+        active = true;
+        set(0);
+        return true;
+#else
+        (void)length;
+        return false;
+#endif
+    }
+
+    bool enabled() const { return active; }
+
+    // Nội dung đã cuộn sang trái `offset` px: x logic nằm ở x + offset trong GRAM
+    void set(int offset) {
+        if (!active) return;
+        offset %= span;
+        if (offset < 0) offset += span;
+        shift = offset;
+        int reg = TFA + (invert ? (span - offset) % span : offset);
+        tft.writecommand(0x37);     // VSCRSADD
+        tft.writedata(reg >> 8);
+        tft.writedata(reg & 0xFF);
+    }
+
+    // Độ lệch hiện tại giữa toạ độ logic và GRAM (0..span-1)
+    int offset() const { return shift; }
+
+    // Trả màn hình về không cuộn (trước khi chuyển sang màn khác)
+    void end() {
+        if (!active) return;
+        set(0);
+        active = false;
+    }
+
+private:
+    enum : int {
+        TFA = Screen::Panel::ROW_START,         // vùng cố định đầu
+        GRAM_LINES = Screen::Panel::GRAM_LINES
+    };
+
+    TFT_eSPI &tft;
+    int span = 0;
+    int shift = 0;
+    bool invert = false;
+    bool active = false;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef INPUT_SERVICE_H
+#define INPUT_SERVICE_H
+
+// Dịch vụ input chung: cạnh nút có đóng dấu thời gian -> chống dội ->
+// 1 snapshot mỗi lượt quét, dùng chung cho report BLE và game.
+// Logic thuần, không phụ thuộc Arduino.
+
+#include <stdint.h>
+#include "Debounce.h"
+#include "BitMask.h"
+
+#define INPUT_MAX_BUTTONS 64
+
+// Trạng thái nút tại 1 lượt quét
+struct InputSnapshot {
+    uint32_t timeUs;            // lúc chụp
+    uint64_t state;             // bit i = nút i đang nhấn (đã chống dội)
+    uint64_t pressed;           // nhấn mới kể từ snapshot trước
+    uint64_t released;          // nhả mới kể từ snapshot trước
+    uint64_t fresh;             // đổi do cạnh thật (đo trễ được), không phải đồng bộ lại
+
+    bool held(uint8_t i) const { return (state >> i) & 1; }
+    bool wasPressed(uint8_t i) const { return (pressed >> i) & 1; }
+    bool wasReleased(uint8_t i) const { return (released >> i) & 1; }
+};
+
+class InputService {
+public:
+    // cfg: mảng count phần tử, hoặc 1 phần tử dùng chung khi shared = true.
+    // initial: bit i = nút i đang nhấn lúc khởi động.
+    void begin(uint8_t count, const DebounceConfig* cfg, bool shared, uint64_t initial, uint32_t nowUs) {
+        numButtons = count < INPUT_MAX_BUTTONS ? count : INPUT_MAX_BUTTONS;
+        for (uint8_t i = 0; i < numButtons; i++) {
+            debouncers[i].begin(shared ? cfg[0] : cfg[i], (initial >> i) & 1, nowUs);
+            pressedAt[i] = releasedAt[i] = nowUs;
+        }
+        lastRaw = debounced = initial;
+        pendingMask = fresh = rose = fell = 0;
+    }
+
+    // Cạnh thô có đóng dấu thời gian (từ ngắt)
+    void edge(uint8_t i, bool pressed, uint32_t t) {
+        if (i >= numButtons) return;
+        Debouncer& d = debouncers[i];
+        if (d.edge(pressed, t)) accept(i);
+        if (d.pending()) pendingMask |= 1ULL << i;
+        else             pendingMask &= ~(1ULL << i);
+    }
+
+    // Kết quả 1 lần quét bank/ma trận: chỉ các bit đổi so với lần trước
+    void scan(uint64_t raw, uint32_t now) {
+        forEachBit((raw ^ lastRaw) & buttonMask(), [&](uint8_t i) { edge(i, (raw >> i) & 1, now); });
+        lastRaw = raw;
+    }
+
+    // Đồng bộ lại toàn bộ từ 1 lần đọc (sau khi mất cạnh); nút không đổi bị bỏ qua
+    void resync(uint64_t raw, uint32_t now) {
+        for (uint8_t i = 0; i < numButtons; i++) edge(i, (raw >> i) & 1, now);
+        lastRaw = raw;
+    }
+
+    // Chụp 1 snapshot: nhận các thay đổi đã hết hạn chống dội tới now
+    InputSnapshot sample(uint32_t now) {
+        forEachBit(pendingMask, [&](uint8_t i) {
+            if (debouncers[i].poll(now)) {
+                accept(i);
+                pendingMask &= ~(1ULL << i);
+            }
+        });
+
+        InputSnapshot s;
+        s.timeUs = now;
+        s.state = debounced;
+        s.pressed = rose;
+        s.released = fell;
+        s.fresh = fresh;
+        rose = fell = fresh = 0;
+        return s;
+    }
+
+    // Micro giây tới hạn chót chống dội gần nhất, DEBOUNCE_NEVER nếu không có
+    uint32_t nextWaitUs(uint32_t now) const {
+        uint32_t waitUs = DEBOUNCE_NEVER;
+        forEachBit(pendingMask, [&](uint8_t i) {
+            uint32_t r = debouncers[i].remaining(now);
+            if (r < waitUs) waitUs = r;
+        });
+        return waitUs;
+    }
+
+    uint8_t count() const { return numButtons; }
+    uint64_t state() const { return debounced; }
+    uint32_t edgeTime(uint8_t i) const { return debouncers[i].edgeTime(); }     // cạnh thô của lần đổi cuối
+    uint32_t acceptTime(uint8_t i) const { return debouncers[i].acceptTime(); }
+    uint32_t pressTime(uint8_t i) const { return pressedAt[i]; }                // cạnh thô của lần nhấn cuối
+    uint32_t releaseTime(uint8_t i) const { return releasedAt[i]; }             // cạnh thô của lần nhả cuối
+
+    uint32_t bounces() const {
+        uint32_t n = 0;
+        for (uint8_t i = 0; i < numButtons; i++) n += debouncers[i].bounces();
+        return n;
+    }
+
+private:
+    Debouncer debouncers[INPUT_MAX_BUTTONS];
+    uint32_t pressedAt[INPUT_MAX_BUTTONS];
+    uint32_t releasedAt[INPUT_MAX_BUTTONS];
+    uint8_t numButtons = 0;
+    uint64_t lastRaw = 0;           // mức thô lần quét trước
+    uint64_t pendingMask = 0;       // bit i = nút i đang chờ hạn chót chống dội
+    uint64_t debounced = 0;         // trạng thái đã lọc
+    uint64_t fresh = 0;             // bit i = đổi do cạnh thật từ snapshot trước
+    uint64_t rose = 0;              // nhấn mới từ snapshot trước
+    uint64_t fell = 0;              // nhả mới từ snapshot trước
+
+    uint64_t buttonMask() const {
+        return numButtons >= 64 ? ~0ULL : (1ULL << numButtons) - 1;
+    }
+
+    void accept(uint8_t i) {
+        uint64_t bit = 1ULL << i;
+        debounced ^= bit;
+        fresh |= bit;
+        if (debounced & bit) {
+            rose |= bit;
+            pressedAt[i] = debouncers[i].edgeTime();
+        } else {
+            fell |= bit;
+            releasedAt[i] = debouncers[i].edgeTime();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+// Histogram độ trễ (micro giây), bucket log2 chia 4: sai số ~12%,
+// 96 bucket phủ tới ~30 s, không cấp phát động.
+class LatencyHistogram {
+public:
+    static const uint8_t SUB_BITS = 2;
+    static const uint8_t NUM_BUCKETS = 24 << SUB_BITS;
+
+    void clear() {
+        for (uint8_t i = 0; i < NUM_BUCKETS; i++) buckets[i] = 0;
+        n = 0;
+        maxUs = 0;
+        sumUs = 0;
+    }
+
+    void add(uint32_t us) {
+        buckets[bucketOf(us)]++;
+        n++;
+        sumUs += us;
+        if (us > maxUs) maxUs = us;
+    }
+
+    uint32_t count() const { return n; }
+    uint32_t worst() const { return maxUs; }
+    uint32_t mean() const { return n ? (uint32_t)(sumUs / n) : 0; }
+
+    // Giá trị tại phân vị p (0..100), lấy cận trên của bucket
+    uint32_t percentile(uint8_t p) const {
+        if (n == 0) return 0;
+        uint32_t rank = ((uint64_t)n * p + 99) / 100;
+        if (rank == 0) rank = 1;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < NUM_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint32_t upper = bucketUpper(i);
+                return upper < maxUs ? upper : maxUs;
+            }
+        }
+        return maxUs;
+    }
+
+    uint32_t median() const { return percentile(50); }
+
+private:
+    uint32_t buckets[NUM_BUCKETS] = {0};
+    uint32_t n = 0;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+
+    static uint8_t bucketOf(uint32_t us) {
+        if (us < (1u << SUB_BITS)) return us;
+        uint8_t msb = 31 - __builtin_clz(us);
+        uint8_t sub = (us >> (msb - SUB_BITS)) & ((1u << SUB_BITS) - 1);
+        uint16_t i = ((msb - SUB_BITS + 1) << SUB_BITS) + sub;
+        return i < NUM_BUCKETS ? i : NUM_BUCKETS - 1;
+    }
+
+    static uint32_t bucketUpper(uint8_t i) {
+        if (i < (1u << SUB_BITS)) return i;
+        uint8_t msb = (i >> SUB_BITS) + SUB_BITS - 1;
+        uint8_t sub = i & ((1u << SUB_BITS) - 1);
+        return ((uint32_t)((1u << SUB_BITS) + sub + 1) << (msb - SUB_BITS)) - 1;
+    }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+// Mô tả panel lúc biên dịch: kích thước gốc (dọc), độ lệch vùng hiển thị
+// trong GRAM và kích thước GRAM. Player, game và renderer nhận PanelView làm
+// tham số template nên kiểm tra biên, cắt và tính cửa sổ gập thành hằng số.
+// TFT_eSPI vẫn đọc driver/chân từ cauhinh.h; thêm panel mới = thêm 1 typedef
+// ở đây và đổi BoardPanel cùng cauhinh.h.
+//
+// Hằng số khai báo bằng enum: dùng được trong biểu thức hằng và truyền
+// theo tham chiếu mà không cần định nghĩa ngoài lớp (C++11).
+
+template <int NATIVE_W_, int NATIVE_H_, int COL_START_, int ROW_START_, int GRAM_COLS_, int GRAM_LINES_>
+struct PanelSpec {
+    enum : int {
+        NATIVE_W = NATIVE_W_,       // rotation 0
+        NATIVE_H = NATIVE_H_,
+        COL_START = COL_START_,     // vùng hiển thị bắt đầu ở cột/dòng này của GRAM (rotation 0)
+        ROW_START = ROW_START_,
+        GRAM_COLS = GRAM_COLS_,     // số cột GRAM theo trục ngang gốc
+        GRAM_LINES = GRAM_LINES_,   // số dòng GRAM theo trục dọc gốc (cuộn phần cứng)
+        // Trục bị lật (MX/MY) thì vùng hiển thị tính từ đầu kia của GRAM
+        COL_START_FLIPPED = GRAM_COLS - COL_START - NATIVE_W,
+        ROW_START_FLIPPED = GRAM_LINES - ROW_START - NATIVE_H
+    };
+};
+
+// ST7735S 0.96" 80x160 (ST7735_GREENTAB160x80), GRAM 132x162
+typedef PanelSpec<80, 160, 26, 1, 132, 162> PanelST7735_80x160;
+// ST7789 1.14" 135x240 (vd. TTGO T-Display), GRAM 240x320
+typedef PanelSpec<135, 240, 52, 40, 240, 320> PanelST7789_135x240;
+// ILI9341 2.4"/2.8" 240x320, GRAM vừa khít
+typedef PanelSpec<240, 320, 0, 0, 240, 320> PanelILI9341_240x320;
+
+// Panel của board này, phải khớp TFT_WIDTH/TFT_HEIGHT trong cauhinh.h
+typedef PanelST7735_80x160 BoardPanel;
+
+// Panel ở 1 rotation cố định (như setRotation của TFT_eSPI). Độ lệch theo
+// bảng xoay của TFT_eSPI: trục cột lật ở rotation 1, 2; trục dòng lật ở 2, 3
+// (vd. ST7789 135x240: cột 52 / 53 / 53 / 52, dòng 40 ở mọi rotation).
+template <class P, int ROT>
+struct PanelView {
+    typedef P Panel;
+    enum : int {
+        ROTATION = ROT & 3,
+        LANDSCAPE = ROT & 1,
+        WIDTH = (ROT & 1) ? P::NATIVE_H : P::NATIVE_W,
+        HEIGHT = (ROT & 1) ? P::NATIVE_W : P::NATIVE_H,
+        COL_OFFSET = (ROTATION == 1 || ROTATION == 2) ? P::COL_START_FLIPPED : P::COL_START,
+        ROW_OFFSET = (ROTATION >= 2) ? P::ROW_START_FLIPPED : P::ROW_START,
+        X_OFFSET = LANDSCAPE ? ROW_OFFSET : COL_OFFSET,         // toạ độ GRAM của x = 0
+        Y_OFFSET = LANDSCAPE ? COL_OFFSET : ROW_OFFSET,
+        PIXELS = WIDTH * HEIGHT
+    };
+
+    static constexpr bool contains(int x, int y) {
+        return x >= 0 && y >= 0 && x < WIDTH && y < HEIGHT;
+    }
+
+    // Phần của đoạn [pos, pos + len) nằm trong [0, limit)
+    static constexpr int clipLen(int pos, int len, int limit) {
+        return pos >= limit || pos + len <= 0 ? 0
+             : (pos + len > limit ? limit : pos + len) - (pos < 0 ? 0 : pos);
+    }
+    static constexpr int clipW(int x, int w) { return clipLen(x, w, WIDTH); }
+    static constexpr int clipH(int y, int h) { return clipLen(y, h, HEIGHT); }
+
+    // Căn giữa 1 khối w x h
+    static constexpr int centerX(int w) { return (WIDTH - w) / 2; }
+    static constexpr int centerY(int h) { return (HEIGHT - h) / 2; }
+};
+
+// Khớp colstart/rowstart của TFT_eSPI cho ST7789 135x240 ở 4 rotation
+static_assert(PanelView<PanelST7789_135x240, 1>::Y_OFFSET == 53 &&
+              PanelView<PanelST7789_135x240, 2>::X_OFFSET == 53 &&
+              PanelView<PanelST7789_135x240, 3>::Y_OFFSET == 52, "độ lệch GRAM theo rotation sai");
+
+#if defined(TFT_WIDTH) && defined(TFT_HEIGHT)
+static_assert(BoardPanel::NATIVE_W == TFT_WIDTH && BoardPanel::NATIVE_H == TFT_HEIGHT,
+              "BoardPanel trong Panel.h không khớp TFT_WIDTH/TFT_HEIGHT của cauhinh.h");
+#endif
+
+#endif
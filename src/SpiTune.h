@@ -0,0 +1,172 @@
+#ifndef SPI_TUNE_H
+#define SPI_TUNE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <TFT_eSPI.h>
+
+// Tự chọn xung SPI cao nhất mà panel chạy ổn định. Các mức là ước số của
+// APB 80 MHz (xung SPI thật của ESP32), thử từ thấp lên; mức đầu tiên hỏng
+// thì dừng và lưu mức trước đó vào NVS. Hỏng ngay mức thấp nhất thì không
+// lưu gì: giữ TFT_SPI_DEFAULT_FREQUENCY, lần hiệu chỉnh sau thử lại.
+// SPI_FREQUENCY trong cauhinh.h trỏ vào tftSpiFrequency, TFT_eSPI đọc lại ở
+// mỗi transaction.
+//  - Có chân đọc (TFT_MISO / TFT_SDA_READ): ghi mẫu ngẫu nhiên rồi đọc lại so sánh.
+//  - Không có (board này): kiểm tra bằng mắt. Màn hình hiện 1 số 1..3 vẽ ở
+//    xung đang thử, nhấn nút đúng số lần đó. Số được vẽ bằng ô bàn cờ 1 px
+//    (mỗi pixel đảo mọi bit so với pixel kề), nên chỉ đọc được khi SPI giữ
+//    đúng mẫu khó nhất; hết giờ hoặc nhấn sai đều tính là hỏng.
+#define SPI_TUNE_CONFIRM_MS 5000    // thời gian chờ nhấn xác nhận mỗi mức
+#define SPI_TUNE_PRESS_GAP_MS 800   // ngừng nhấn lâu hơn = xong 1 lượt đếm
+#define SPI_TUNE_BLOCK 16           // cạnh khối mẫu đọc lại
+#define SPI_TUNE_ROUNDS 4           // số khối đọc lại mỗi mức
+#define SPI_TUNE_DIGIT_SIZE 3       // cỡ chữ của số xác nhận (font 6x8)
+
+uint32_t tftSpiFrequency = TFT_SPI_DEFAULT_FREQUENCY;
+
+const uint32_t spiTuneSteps[] = { 20000000, 26666667, 40000000, 80000000 };
+const uint8_t SPI_TUNE_STEP_COUNT = sizeof(spiTuneSteps) / sizeof(spiTuneSteps[0]);
+
+class SpiTuner {
+public:
+    typedef bool (*PressFn)();      // true khi có 1 lần nhấn mới
+
+    // Đọc mức đã lưu vào tftSpiFrequency; false nếu chưa hiệu chỉnh
+    bool load() {
+        Preferences prefs;
+        prefs.begin("tft", true);
+        uint32_t hz = prefs.getUInt("spi_hz", 0);
+        prefs.end();
+        if (!valid(hz)) return false;
+        tftSpiFrequency = hz;
+        return true;
+    }
+
+    // Chạy hiệu chỉnh trên màn hình đã begin(), lưu và trả về mức chọn được;
+    // 0 nếu mức thấp nhất đã hỏng (không lưu, giữ mức mặc định).
+    // pressed chỉ cần khi không đọc lại được từ panel.
+    uint32_t calibrate(TFT_eSPI& tft, PressFn pressed) {
+        rng = esp_random() | 1;
+        uint32_t best = 0;
+        for (uint8_t i = 0; i < SPI_TUNE_STEP_COUNT; i++) {
+            tftSpiFrequency = spiTuneSteps[i];
+            bool ok = check(tft, pressed);
+            Serial.printf("spi tune: %.2f MHz %s\n", spiTuneSteps[i] / 1e6f, ok ? "ok" : "fail");
+            if (!ok) break;
+            best = spiTuneSteps[i];
+        }
+
+        tftSpiFrequency = best ? best : TFT_SPI_DEFAULT_FREQUENCY;
+        if (best) {
+            Preferences prefs;
+            prefs.begin("tft", false);
+            prefs.putUInt("spi_hz", best);
+            prefs.end();
+        }
+
+        tft.fillScreen(TFT_BLACK);
+        tft.setTextColor(best ? TFT_GREEN : TFT_RED, TFT_BLACK);
+        tft.setTextSize(1);
+        tft.setCursor(2, 2);
+        if (best) tft.printf("SPI %.2f MHz", best / 1e6f);
+        else      tft.printf("SPI tune failed");
+        delay(1000);
+        return best;
+    }
+
+private:
+    uint32_t rng = 0x9E3779B9;
+
+    static bool valid(uint32_t hz) {
+        for (uint8_t i = 0; i < SPI_TUNE_STEP_COUNT; i++) {
+            if (spiTuneSteps[i] == hz) return true;
+        }
+        return false;
+    }
+
+    uint32_t random32() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    bool check(TFT_eSPI& tft, PressFn pressed) {
+        drawPattern(tft);
+#if defined(TFT_MISO) || defined(TFT_SDA_READ)
+        (void)pressed;
+        return readback(tft);
+#else
+        return confirm(tft, pressed);
+#endif
+    }
+
+    // Sọc 1 px đen/trắng (mọi bit đảo liên tục) và dải màu cơ bản
+    void drawPattern(TFT_eSPI& tft) {
+        int w = tft.width(), h = tft.height();
+        tft.fillScreen(TFT_BLACK);
+        for (int x = 0; x < w; x += 2) tft.drawFastVLine(x, 0, h / 4, TFT_WHITE);
+        for (int y = h / 4; y < h / 2; y += 2) tft.drawFastHLine(0, y, w, TFT_WHITE);
+        const uint16_t bars[] = { TFT_RED, TFT_GREEN, TFT_BLUE, TFT_YELLOW, TFT_CYAN, TFT_MAGENTA };
+        const int n = sizeof(bars) / sizeof(bars[0]);
+        for (int i = 0; i < n; i++) tft.fillRect(i * w / n, h / 2, (i + 1) * w / n - i * w / n, h / 8, bars[i]);
+    }
+
+#if defined(TFT_MISO) || defined(TFT_SDA_READ)
+    bool readback(TFT_eSPI& tft) {
+        uint16_t block[SPI_TUNE_BLOCK * SPI_TUNE_BLOCK];
+        uint16_t back[SPI_TUNE_BLOCK * SPI_TUNE_BLOCK];
+        for (uint8_t r = 0; r < SPI_TUNE_ROUNDS; r++) {
+            for (uint16_t i = 0; i < SPI_TUNE_BLOCK * SPI_TUNE_BLOCK; i++) block[i] = random32();
+            int x = r * SPI_TUNE_BLOCK % (tft.width() - SPI_TUNE_BLOCK);
+            int y = tft.height() - SPI_TUNE_BLOCK;
+            tft.pushImage(x, y, SPI_TUNE_BLOCK, SPI_TUNE_BLOCK, block);
+            tft.readRect(x, y, SPI_TUNE_BLOCK, SPI_TUNE_BLOCK, back);
+            if (memcmp(block, back, sizeof(block)) != 0) return false;
+        }
+        return true;
+    }
+#else
+    bool confirm(TFT_eSPI& tft, PressFn pressed) {
+        uint8_t code = 1 + random32() % 3;
+        if (!drawDigit(tft, code)) return false;
+
+        while (pressed()) {}        // bỏ lần nhấn còn sót từ mức trước
+        uint8_t count = 0;
+        uint32_t start = millis(), last = 0;
+        while (millis() - start < SPI_TUNE_CONFIRM_MS) {
+            if (pressed()) {
+                count++;
+                last = millis();
+            }
+            if (count && millis() - last > SPI_TUNE_PRESS_GAP_MS) break;
+            delay(5);
+        }
+        return count == code;
+    }
+
+    // Vẽ số vào sprite rồi xoá ô bàn cờ: nét chữ chỉ còn pixel trắng/đen xen
+    // kẽ, đẩy 1 lần qua SPI ở xung đang thử
+    bool drawDigit(TFT_eSPI& tft, uint8_t code) {
+        const int w = 6 * SPI_TUNE_DIGIT_SIZE, h = 8 * SPI_TUNE_DIGIT_SIZE;
+        TFT_eSprite digit(&tft);
+        digit.setColorDepth(16);
+        uint16_t* px = (uint16_t*)digit.createSprite(w, h);
+        if (!px) return false;
+        digit.fillSprite(TFT_BLACK);
+        digit.setTextColor(TFT_WHITE, TFT_BLACK);
+        digit.setTextSize(SPI_TUNE_DIGIT_SIZE);
+        digit.setCursor(0, 0);
+        digit.print(code);
+        for (int y = 0; y < h; y++) {
+            for (int x = (y & 1) ^ 1; x < w; x += 2) px[y * w + x] = TFT_BLACK;
+        }
+        int top = tft.height() * 5 / 8;
+        digit.pushSprite((tft.width() - w) / 2, top + (tft.height() - top - h) / 2);
+        digit.deleteSprite();
+        return true;
+    }
+#endif
+};
+
+#endif
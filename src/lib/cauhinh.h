@@ -1,7 +1,7 @@
 #define ST7735_DRIVER
 #define ST7735_GREENTAB160x80  // chuẩn cho màn hình 160x80 ST7735S
 
-#define TFT_WIDTH  80
+#define TFT_WIDTH  80     // khớp BoardPanel trong Panel.h
 #define TFT_HEIGHT 160
 
 #define TFT_CS   5
@@ -18,4 +18,12 @@
 #define TFT_RGB_ORDER TFT_BGR     // nếu màu sai, thử đổi sang TFT_RGB
 #define TFT_INVERSION_ON          // hoặc _OFF nếu bị âm
 
-#define SPI_FREQUENCY  27000000
+// Xung SPI ghi là biến lúc chạy: SpiTune.h hiệu chỉnh và lưu NVS, TFT_eSPI
+// đọc lại ở mỗi transaction. Chưa hiệu chỉnh thì dùng mức mặc định.
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+extern uint32_t tftSpiFrequency;
+#endif
+#define TFT_SPI_DEFAULT_FREQUENCY 27000000
+#define SPI_FREQUENCY  tftSpiFrequency
+#define SPI_READ_FREQUENCY 10000000   // chỉ dùng khi có chân đọc (TFT_MISO)
@@ -1,34 +1,398 @@
 #include <BleGamepad.h>
+#include "AppMode.h"
+#include "video_player.h"
+#include "FlappyBird.h"
+#include "ButtonEvents.h"
+#include "ButtonScan.h"
+#include "InputService.h"
+#include "GamepadCore.h"
+#include "BleProfile.h"
+#include "SpiTune.h"
 
-// 3 nút: GPIO0, GPIO20, GPIO21
-const int btnPins[] = {0, 20, 21};
+// Tiết kiệm pin: light sleep tự động khi chờ nút, deep sleep khi mất kết nối lâu
+// #define GAMEPAD_POWER_SAVE
+#ifdef GAMEPAD_POWER_SAVE
+#include "GamepadPower.h"
+GamepadPower power;
+#endif
+
+// Đo trễ từng chặng nút -> HID, xem qua Serial ('l' in, 'c' xoá)
+// #define HID_LATENCY_TRACE
+#ifdef HID_LATENCY_TRACE
+#include "HidLatency.h"
+HidLatency hidTrace;
+#endif
+
+AppModeManager appMode;
+
+// 3 nút: GPIO0, GPIO20, GPIO21. Trên ESP32-C3 GPIO20/21 là RX/TX của UART0,
+// nên Serial chạy qua USB CDC (GPIO18/19, xem platformio.ini)
+constexpr int btnPins[] = {0, 20, 21};
 const int NUM_BTNS = sizeof(btnPins)/sizeof(btnPins[0]);
 
-bool lastBtnState[3] = {0};
+// Chống dội riêng từng chân: nút bấm nhanh dùng eager (nhấn ngay, nhả trễ),
+// công tắc dội lâu dùng integrator
+const DebounceConfig btnDebounce[] = {
+  {DEBOUNCE_EAGER, 5000, 8000},
+  {DEBOUNCE_EAGER, 5000, 8000},
+  {DEBOUNCE_EAGER, 5000, 8000},
+};
+
+// Chân màn hình trong cauhinh.h: nút, ma trận và ADC không được dùng lại
+constexpr bool isTftPin(int pin) {
+  return pin == TFT_CS || pin == TFT_DC || pin == TFT_RST || pin == TFT_MOSI || pin == TFT_SCLK;
+}
+
+// Chân của Serial: USB D-/D+ khi chạy qua USB CDC, còn lại là TX/RX của UART0
+constexpr bool isSerialPin(int pin) {
+#if ARDUINO_USB_CDC_ON_BOOT
+  return pin == 18 || pin == 19;
+#elif CONFIG_IDF_TARGET_ESP32C3
+  return pin == 20 || pin == 21;
+#else
+  return pin == 1 || pin == 3;
+#endif
+}
+
+template <size_t N>
+constexpr bool anyPin(const int (&pins)[N], bool (*match)(int), size_t i = 0) {
+  return i < N && (match(pins[i]) || anyPin(pins, match, i + 1));
+}
+
+static_assert(!anyPin(btnPins, isTftPin), "btnPins trùng chân màn hình");
+static_assert(!anyPin(btnPins, isSerialPin), "btnPins trùng chân Serial");
+
+// Ma trận phím hàng/cột thay cho nút nối thẳng (không có ngắt, quét định kỳ).
+// ESP32-C3 chỉ còn GPIO2, 6, 7, 9, 10 sau màn hình, 3 nút và USB (Serial):
+// ma trận 2x2, chừa GPIO2 cho ADC. ESP32 DevKit không được dùng GPIO6..11 (flash).
+// #define BUTTON_MATRIX
+#ifdef BUTTON_MATRIX
+#if CONFIG_IDF_TARGET_ESP32C3
+constexpr int matrixRows[] = {6, 7};
+constexpr int matrixCols[] = {9, 10};
+#else
+constexpr int matrixRows[] = {13, 14, 16, 17};
+constexpr int matrixCols[] = {25, 26, 27, 32};
+#endif
+static_assert(!anyPin(matrixRows, isTftPin) && !anyPin(matrixCols, isTftPin), "ma trận phím trùng chân màn hình");
+static_assert(!anyPin(matrixRows, isSerialPin) && !anyPin(matrixCols, isSerialPin), "ma trận phím trùng chân Serial");
+const DebounceConfig matrixDebounce = {DEBOUNCE_INTEGRATOR, 5000, 5000};
+#define MATRIX_SCAN_MS 1
+#endif
+
+ButtonScanner scanner;
+InputService input;             // 1 snapshot nút đã chống dội mỗi lượt, dùng chung mọi chế độ
+uint32_t lastDropped = 0;
 
 BleGamepad bleGamepad("ESP32 Gamepad", "DIY", 100);
+BleGamepadConfiguration bleGamepadConfig;
+BleProfileManager bleProfile;   // đổi khoảng kết nối theo hoạt động
 
-void setup() {
-  for (int i = 0; i < NUM_BTNS; i++) {
-    pinMode(btnPins[i], INPUT_PULLUP);
-    lastBtnState[i] = digitalRead(btnPins[i]) == LOW;
+// Nối GamepadCore với BleGamepad, kèm các móc đo trễ/tiết kiệm pin
+class BleReporter : public GamepadReporter {
+public:
+  bool isConnected() override { return bleGamepad.isConnected(); }
+  void press(uint8_t button) override { bleGamepad.press(button); }
+  void release(uint8_t button) override { bleGamepad.release(button); }
+
+  void setAxis(uint8_t axis, int16_t value) override {
+    switch (axis) {
+      case 0: bleGamepad.setX(value); break;
+      case 1: bleGamepad.setY(value); break;
+      case 2: bleGamepad.setZ(value); break;
+      case 3: bleGamepad.setRZ(value); break;
+    }
   }
 
-  bleGamepad.begin();
+  uint32_t sendReport(uint32_t nowUs) override {
+#ifdef HID_LATENCY_TRACE
+    hidTrace.queued(nowUs);
+#else
+    (void)nowUs;
+#endif
+    bleGamepad.sendReport();
+    uint32_t sent = micros();
+#ifdef HID_LATENCY_TRACE
+    hidTrace.sent(sent);
+#endif
+#ifdef GAMEPAD_POWER_SAVE
+    power.reportSent();
+#endif
+    return sent;
+  }
+
+#ifdef HID_LATENCY_TRACE
+  void timedChange(uint32_t edgeUs, uint32_t acceptUs) override { hidTrace.addEdge(edgeUs, acceptUs); }
+#endif
+};
+
+BleReporter bleReporter;
+GamepadCore gamepad(bleReporter, input);
+
+// Cần/cò analog qua ADC liên tục (DMA), gửi khi đổi quá ngưỡng
+// #define GAMEPAD_AXES
+#ifdef GAMEPAD_AXES
+#include "AnalogAxes.h"
+#if CONFIG_IDF_TARGET_ESP32C3
+// ADC1 của C3 là GPIO0..4: GPIO0 là nút A, GPIO1/3/4 là DC/MOSI/SCLK của
+// màn hình, chỉ còn GPIO2 cho 1 trục (cần X trái)
+constexpr int axisPins[] = {2};               // ADC1 CH2
+#else
+constexpr int axisPins[] = {34, 35, 32, 33};  // ADC1 CH6, CH7, CH4, CH5
+#endif
+static_assert(!anyPin(axisPins, isTftPin), "axisPins trùng chân màn hình");
+static_assert(!anyPin(axisPins, isSerialPin), "axisPins trùng chân Serial");
+// Cần X/Y trái, cần X/Y phải: hiệu chuẩn mặc định, center đo lúc khởi động
+const AxisCalibration axisCal[] = {
+  {150, 2048, 3950, 120, false},
+  {150, 2048, 3950, 120, true},
+  {150, 2048, 3950, 120, false},
+  {150, 2048, 3950, 120, true},
+};
+#define AXIS_POLL_MS 5
+AnalogAxes axes;
+#endif
+
+// Cạnh nút đến qua ngắt; loop ngủ tới khi có cạnh thay vì quét mỗi 5ms.
+// Bật BUTTON_POLL_BASELINE để quay về nhịp 5ms cũ (vẫn đóng dấu thời gian
+// bằng ngắt) khi cần so độ trễ trước/sau.
+// #define BUTTON_POLL_BASELINE
+#define IDLE_WAIT_MS 100
+#define LATENCY_REPORT_MS 10000
+
+ButtonEvents buttons;
+uint32_t lastLatencyReport = 0;
+uint32_t lastBounces = 0;
+
+void inputSetup() {
+#ifdef BUTTON_MATRIX
+  scanner.beginMatrix(matrixRows, sizeof(matrixRows) / sizeof(matrixRows[0]),
+                      matrixCols, sizeof(matrixCols) / sizeof(matrixCols[0]));
+  input.begin(scanner.count(), &matrixDebounce, true, scanner.scan(), micros());
+#else
+  scanner.beginPins(btnPins, NUM_BTNS);
+  buttons.begin(btnPins, NUM_BTNS);
+  input.begin(scanner.count(), btnDebounce, false, scanner.scan(), micros());
+#endif
 }
 
-void loop() {
-  if (bleGamepad.isConnected()) {
-    for (int i = 0; i < NUM_BTNS; i++) {
-      bool pressed = (digitalRead(btnPins[i]) == LOW); // LOW = nhấn
-      if (pressed != lastBtnState[i]) {
-        lastBtnState[i] = pressed;
-        int btnIndex = i + 1; // nút số 1,2,3
-        if (pressed) bleGamepad.press(btnIndex);
-        else         bleGamepad.release(btnIndex);
-      }
-    }
+// Chân nút chỉ được đọc ở đây: cạnh từ ngắt qua bộ chống dội, rồi 1 snapshot
+InputSnapshot inputPoll() {
+  ButtonEvent ev;
+  while (buttons.pop(ev)) input.edge(ev.index, ev.pressed, ev.timeUs);
+
+  uint32_t now = micros();
+#ifdef BUTTON_MATRIX
+  // 1 lượt quét cả ma trận, chỉ xử lý các nút có bit đổi
+  input.scan(scanner.scan(), now);
+#else
+  // Hàng đợi ngắt bị tràn: mất cạnh, lấy lại mức thật bằng 1 lần đọc bank
+  if (buttons.dropped() != lastDropped) {
+    lastDropped = buttons.dropped();
+    input.resync(scanner.scan(), now);
+  }
+#endif
+  return input.sample(now);
+}
+
+// Thời điểm micros() của cạnh đổi sang millis() (2 đồng hồ tràn ở mốc khác nhau)
+uint32_t edgeMillis(uint32_t edgeUs) {
+  return millis() - (micros() - edgeUs) / 1000;
+}
+
+void reportLatency() {
+  if (millis() - lastLatencyReport < LATENCY_REPORT_MS) return;
+  lastLatencyReport = millis();
+  uint32_t bounces = input.bounces();
+  uint32_t newBounces = bounces - lastBounces;
+  lastBounces = bounces;
+  const LatencyHistogram& lat = gamepad.latency();
+  if (lat.count() == 0 && newBounces == 0) return;
+  Serial.printf("btn->hid n=%lu reports=%lu median=%luus p99=%luus max=%luus dropped=%lu bounce/s=%.1f\n",
+                (unsigned long)lat.count(), (unsigned long)gamepad.reports(), (unsigned long)lat.median(),
+                (unsigned long)lat.percentile(99), (unsigned long)lat.worst(),
+                (unsigned long)buttons.dropped(), newBounces * 1000.0f / LATENCY_REPORT_MS);
+}
+
+#ifdef GAMEPAD_POWER_SAVE
+// Dòng điện ước tính in theo nhịp riêng, cả khi không có nút nào được nhấn
+#define POWER_REPORT_MS 10000
+uint32_t lastPowerReport = 0;
+
+void reportPower() {
+  if (millis() - lastPowerReport < POWER_REPORT_MS) return;
+  lastPowerReport = millis();
+  power.print();
+}
+#endif
+
+// Thời gian chờ tới hạn chót chống dội hoặc lượt gửi report gần nhất (ms, làm tròn lên)
+uint32_t nextWaitMs() {
+  uint32_t now = micros();
+  uint32_t waitUs = input.nextWaitUs(now);
+  uint32_t reportUs = gamepad.nextWaitUs(now);
+  if (reportUs < waitUs) waitUs = reportUs;
+  uint32_t ms = waitUs == DEBOUNCE_NEVER ? IDLE_WAIT_MS : (waitUs + 999) / 1000;
+#ifdef BUTTON_MATRIX
+  if (ms > MATRIX_SCAN_MS) ms = MATRIX_SCAN_MS;
+#endif
+#ifdef GAMEPAD_AXES
+  if (ms > AXIS_POLL_MS) ms = AXIS_POLL_MS;
+#endif
+  return ms < IDLE_WAIT_MS ? ms : IDLE_WAIT_MS;
+}
+
+void gamepadSetup() {
+#ifdef GAMEPAD_POWER_SAVE
+  power.begin();
+#endif
+
+  inputSetup();
+#if defined(GAMEPAD_POWER_SAVE) && !defined(BUTTON_MATRIX)
+  buttons.enableWakeup();
+#endif
+  gamepad.begin();
+
+  // Tự gửi report: tắt, GamepadCore gom thay đổi và gửi tối đa 1 report mỗi khoảng kết nối
+  bleGamepadConfig.setAutoReport(false);
+  bleGamepadConfig.setButtonCount(scanner.count());
+  bleGamepad.begin(&bleGamepadConfig);
+
+#ifdef GAMEPAD_AXES
+  if (axes.begin(axisPins, axisCal, sizeof(axisPins) / sizeof(axisPins[0]))) {
+    delay(50);                  // vài khung DMA để có điểm nghỉ
+    axes.poll();
+    axes.calibrateCenter();
+  } else {
+    Serial.println("axes: ADC init failed");
   }
+#endif
+}
 
+void gamepadLoop() {
+#ifdef BUTTON_POLL_BASELINE
   delay(5);
-}
\ No newline at end of file
+#elif defined(GAMEPAD_POWER_SAVE)
+  uint32_t waitStart = micros();
+  buttons.wait(nextWaitMs());
+  power.idle(micros() - waitStart);
+#else
+  buttons.wait(nextWaitMs());
+#endif
+
+  // Gom mọi thay đổi của snapshot vào report đang chờ
+  InputSnapshot snap = inputPoll();
+
+  bool connected = bleGamepad.isConnected();
+  bleProfile.update(millis(), connected);
+  gamepad.setReportInterval(bleProfile.intervalUs());
+#ifdef GAMEPAD_POWER_SAVE
+  power.update(millis(), connected, btnPins[0]);
+#endif
+#ifdef GAMEPAD_AXES
+  if (axes.poll() && connected) {
+    for (uint8_t i = 0; i < axes.count(); i++) {
+      if (!axes.changed(i)) continue;
+      gamepad.setAxis(i, axes.value(i));
+      axes.markReported(i);
+    }
+  }
+#endif
+
+  // Gửi các nút khác với host (cả khi vừa nối lại sau lúc mất kết nối),
+  // tối đa 1 report mỗi khoảng kết nối
+  if (gamepad.update(snap)) bleProfile.activity(millis());
+
+  // Giữ cả 3 nút: đổi chế độ (B+C riêng vẫn gửi lên host bình thường)
+  appMode.pollChord((snap.state & 0x7) == 0x7, millis());
+
+  reportLatency();
+#ifdef GAMEPAD_POWER_SAVE
+  reportPower();
+#endif
+#ifdef HID_LATENCY_TRACE
+  hidTrace.poll();
+#endif
+}
+
+// ---- Video và game: chỉ màn hình, không BLE ----
+
+// Game chạy ngang 160x80, cùng hướng với video: nền cuộn bằng cuộn phần cứng
+// của ST7735 (HwScroll chỉ chạy ở chiều ngang)
+typedef PanelView<BoardPanel, 3> GameScreen;
+FlappyBird<GameScreen> flappy(tft, btnPins[0]);
+SpiTuner spiTune;
+
+bool tunePressed() {
+  return inputPoll().wasPressed(0);
+}
+
+// Xung SPI đã hiệu chỉnh từ NVS, chưa có thì TFT_SPI_DEFAULT_FREQUENCY.
+// Chỉ hiệu chỉnh khi đang giữ nút A lúc khởi động (nhấn ngay sau khi nhả
+// reset, không giữ từ trước: GPIO0 là chân vào chế độ nạp), để lần khởi động
+// đầu không bị chặn chờ xác nhận. Trả về true nếu đã dùng màn hình.
+bool displayTune() {
+  spiTune.load();
+  if (!(input.state() & 1)) return false;
+  tft.begin();
+  tft.setRotation(VideoScreen::ROTATION);
+  spiTune.calibrate(tft, tunePressed);
+  return true;
+}
+
+// Gọi giữa các frame video: tổ hợp nút đổi chế độ (khởi động lại)
+bool videoStop() {
+  appMode.pollChord((inputPoll().state & 0x6) == 0x6, millis());
+  return false;
+}
+
+void videoLoop() {
+  playVideos(videoStop, true);
+}
+
+void videoSetup() {
+  inputSetup();
+  // Frame đầu trước mọi việc khác; playPlaylist init lại màn hình sau
+  if (!displayTune()) showBootFrame<VideoScreen>();
+  appMode.releaseRadio();
+}
+
+void gameSetup() {
+  appMode.releaseRadio();
+  inputSetup();
+  displayTune();
+  tft.begin();
+  tft.setRotation(GameScreen::ROTATION);
+  flappy.begin();
+}
+
+void gameLoop() {
+  InputSnapshot snap = inputPoll();
+  flappy.setButton(snap.held(0), snap.wasPressed(0), edgeMillis(input.pressTime(0)),
+                   snap.wasReleased(0), edgeMillis(input.releaseTime(0)));
+  flappy.update();
+  appMode.pollChord((snap.state & 0x6) == 0x6, millis());
+}
+
+void setup() {
+  Serial.begin(115200);
+#if ARDUINO_USB_CDC_ON_BOOT
+  Serial.setTxTimeoutMs(0);     // không cắm USB: bỏ log thay vì chặn loop
+#endif
+  AppMode mode = appMode.begin(btnPins[1], btnPins[2]);
+  Serial.printf("mode: %s\n", AppModeManager::name(mode));
+
+  switch (mode) {
+    case APP_VIDEO:   videoSetup(); break;
+    case APP_GAME:    gameSetup(); break;
+    default:          gamepadSetup(); break;
+  }
+}
+
+void loop() {
+  switch (appMode.mode()) {
+    case APP_VIDEO:   videoLoop(); break;
+    case APP_GAME:    gameLoop(); break;
+    default:          gamepadLoop(); break;
+  }
+}
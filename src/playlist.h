@@ -0,0 +1,114 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <Arduino.h>
+
+typedef struct _VideoInfo VideoInfo;
+
+#define PLAYLIST_MAX 16
+
+enum PlaylistOrder : uint8_t {
+    PLAYLIST_SEQUENTIAL = 0,    // theo thứ tự khai báo
+    PLAYLIST_SHUFFLE,           // xáo trộn mỗi vòng, không lặp clip liền nhau
+    PLAYLIST_WEIGHTED           // chọn ngẫu nhiên theo trọng số
+};
+
+// 1 mục trong playlist: đoạn [in_frame, out_frame) của clip, lặp loops lần
+typedef struct _PlaylistEntry {
+    const VideoInfo* video;
+    uint16_t in_frame;
+    uint16_t out_frame;     // 0 = đến hết clip
+    uint8_t loops;          // 0 hoặc 1 = chạy 1 lần
+    uint8_t weight;         // chỉ dùng cho PLAYLIST_WEIGHTED (0 = bỏ qua)
+} PlaylistEntry;
+
+class Playlist {
+public:
+    // repeat = true: chạy vô hạn (kiosk)
+    Playlist(const PlaylistEntry* entries, uint8_t count,
+             PlaylistOrder order = PLAYLIST_SEQUENTIAL, bool repeat = false)
+        : entries(entries), count(count > PLAYLIST_MAX ? PLAYLIST_MAX : count),
+          order(order), repeat(repeat) {
+        reset();
+    }
+
+    void reset() {
+        played = 0;
+        pos = 0;
+        last = -1;
+        if (order == PLAYLIST_SHUFFLE) shuffle();
+        upcoming = pick();
+    }
+
+    // Mục kế tiếp, nullptr khi hết playlist
+    const PlaylistEntry* next() {
+        if (upcoming < 0) return nullptr;
+        last = upcoming;
+        played++;
+        upcoming = pick();
+        return &entries[last];
+    }
+
+    // Xem trước mục sẽ chạy sau (để chuẩn bị frame đầu), không đổi trạng thái
+    const PlaylistEntry* peek() const {
+        return upcoming < 0 ? nullptr : &entries[upcoming];
+    }
+
+private:
+    const PlaylistEntry* entries;
+    uint8_t count;
+    PlaylistOrder order;
+    bool repeat;
+
+    uint8_t perm[PLAYLIST_MAX];
+    uint8_t pos;
+    uint32_t played;
+    int16_t last;
+    int16_t upcoming;
+
+    int16_t pick() {
+        if (count == 0) return -1;
+        if (!repeat && played >= count) return -1;
+
+        switch (order) {
+        case PLAYLIST_SHUFFLE:
+            if (pos >= count) {
+                shuffle();
+                // Tránh chạy lại đúng clip vừa xong ở đầu vòng mới
+                if (count > 1 && perm[0] == last) {
+                    uint8_t t = perm[0]; perm[0] = perm[1]; perm[1] = t;
+                }
+            }
+            return perm[pos++];
+
+        case PLAYLIST_WEIGHTED: {
+            uint32_t total = 0;
+            for (uint8_t i = 0; i < count; i++) total += entries[i].weight;
+            if (total == 0) return played % count;
+            uint32_t r = random(total);
+            for (uint8_t i = 0; i < count; i++) {
+                if (r < entries[i].weight) return i;
+                r -= entries[i].weight;
+            }
+            return count - 1;
+        }
+
+        default: {
+            int16_t i = pos;
+            pos = (pos + 1) % count;
+            return i;
+        }
+        }
+    }
+
+    void shuffle() {
+        for (uint8_t i = 0; i < count; i++) perm[i] = i;
+        for (uint8_t i = count; i > 1; i--) {
+            uint8_t j = random(i);
+            uint8_t t = perm[i - 1]; perm[i - 1] = perm[j]; perm[j] = t;
+        }
+        pos = 0;
+    }
+};
+
+#endif
@@ -3,14 +3,62 @@
 
 #include <TFT_eSPI.h>
 #include <TJpg_Decoder.h>
+#include "Panel.h"
+
+// Màn hình khi phát video: panel của board xoay ngang
+typedef PanelView<BoardPanel, 3> VideoScreen;
+
+#include "BootFrame.h"
 
 // ====== Khai báo cấu trúc video ======
+// Kích thước track gốc (các frame trong videoXX.h)
+#define VIDEO_FULL_W 160
+#define VIDEO_FULL_H 80
+
+enum VideoTrackKind : uint8_t {
+    VIDEO_TRACK_FULL = 0,   // chất lượng đầy đủ 160x80
+    VIDEO_TRACK_LOW,        // bitrate thấp, cùng kích thước
+    VIDEO_TRACK_THUMB       // thumbnail cho menu preview
+};
+
+// 1 track mã hoá JPEG của clip
+typedef struct _VideoTrack {
+    const uint8_t* const* frames;
+    const uint16_t* frames_size;
+    uint16_t num_frames;
+    uint16_t width;
+    uint16_t height;
+    VideoTrackKind kind;
+} VideoTrack;
+
+// Các trường đầu là track đầy đủ (giữ tương thích với videoXX.h cũ).
+// Track phụ khai báo thêm trong header của clip, ví dụ:
+//   const VideoTrack video01_tracks[] = {
+//       { video01_lo_frames, video01_lo_frame_sizes, 80, 160, 80, VIDEO_TRACK_LOW },
+//       { video01_th_frames, video01_th_frame_sizes, 20,  40, 20, VIDEO_TRACK_THUMB },
+//   };
+//   VideoInfo video01 = { video01_frames, video01_frame_sizes, video01_NUM_FRAMES,
+//                         video01_tracks, 2 };
 typedef struct _VideoInfo {
     const uint8_t* const* frames;
     const uint16_t* frames_size;
     uint16_t num_frames;
+    const VideoTrack* tracks;   // nullptr = chỉ có track đầy đủ
+    uint8_t num_tracks;
 } VideoInfo;
 
+// Giới hạn khi chọn track lúc chạy
+typedef struct _TrackBudget {
+    uint16_t max_w;             // vùng hiển thị
+    uint16_t max_h;
+    uint32_t max_frame_bytes;   // ngân sách decode: byte JPEG trung bình / frame (0 = không giới hạn)
+    uint32_t min_free_heap;     // heap thấp hơn ngưỡng này -> chọn track nhẹ nhất (0 = bỏ qua)
+} TrackBudget;
+
+#include "playlist.h"
+
+#define VIDEO_FRAME_DELAY_MS 30     // thời gian giữ mỗi frame sau khi vẽ
+
 // ====== INCLUDE tất cả video .h ======
 #include "video01.h"
 #include "video02.h"
@@ -26,45 +74,251 @@ const uint8_t NUM_VIDEOS = sizeof(videoList) / sizeof(videoList[0]);
 
 TFT_eSPI tft = TFT_eSPI();
 
-// Callback vẽ ảnh
-bool tft_output(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* bitmap) {
-    if (x >= tft.width() || y >= tft.height()) return true;
+// Số track của clip (track 0 = track đầy đủ)
+uint8_t videoTrackCount(const VideoInfo* video) {
+    return 1 + (video->tracks ? video->num_tracks : 0);
+}
+
+VideoTrack videoTrack(const VideoInfo* video, uint8_t index) {
+    if (index == 0 || !video->tracks || index > video->num_tracks) {
+        VideoTrack full = { video->frames, video->frames_size, video->num_frames,
+                            VIDEO_FULL_W, VIDEO_FULL_H, VIDEO_TRACK_FULL };
+        return full;
+    }
+    return video->tracks[index - 1];
+}
+
+// Byte JPEG trung bình / frame, dùng làm thước đo chi phí decode
+uint32_t trackAvgFrameBytes(const VideoTrack* track) {
+    if (track->num_frames == 0) return 0;
+    uint32_t total = 0;
+    for (uint16_t f = 0; f < track->num_frames; f++) {
+        total += pgm_read_word(&track->frames_size[f]);
+    }
+    return total / track->num_frames;
+}
+
+// Chọn track tốt nhất vừa màn hình và ngân sách decode.
+// Ưu tiên diện tích lớn nhất, rồi bitrate cao nhất; nếu không track nào
+// vừa thì lấy track nhẹ nhất (drawTrackFrame sẽ thu nhỏ bằng JPEG scale).
+VideoTrack selectVideoTrack(const VideoInfo* video, const TrackBudget& budget) {
+    uint8_t count = videoTrackCount(video);
+    bool lowMemory = budget.min_free_heap && ESP.getFreeHeap() < budget.min_free_heap;
+
+    int best = -1, lightest = 0;
+    uint32_t bestArea = 0, bestBytes = 0, lightestBytes = UINT32_MAX;
+
+    for (uint8_t i = 0; i < count; i++) {
+        VideoTrack t = videoTrack(video, i);
+        uint32_t bytes = trackAvgFrameBytes(&t);
+        if (bytes < lightestBytes) {
+            lightestBytes = bytes;
+            lightest = i;
+        }
+        if (t.width > budget.max_w || t.height > budget.max_h) continue;
+        if (budget.max_frame_bytes && bytes > budget.max_frame_bytes) continue;
+
+        uint32_t area = (uint32_t)t.width * t.height;
+        if (area > bestArea || (area == bestArea && bytes > bestBytes)) {
+            best = i;
+            bestArea = area;
+            bestBytes = bytes;
+        }
+    }
+
+    if (lowMemory || best < 0) return videoTrack(video, lightest);
+    return videoTrack(video, best);
+}
+
+// Hệ số thu nhỏ JPEG (1, 2, 4, 8) để track vừa vùng max_w x max_h
+uint8_t trackJpgScale(const VideoTrack* track, uint16_t max_w, uint16_t max_h) {
+    uint8_t scale = 1;
+    while (scale < 8 && (track->width / scale > max_w || track->height / scale > max_h)) {
+        scale <<= 1;
+    }
+    return scale;
+}
+
+// Buffer đích khi decode trước (nullptr = vẽ thẳng ra màn hình)
+uint16_t* jpgTarget = nullptr;
+int16_t jpgTargetW = 0, jpgTargetH = 0;
+
+// Callback vẽ ảnh. Khối MCU luôn bắt đầu ở x, y >= 0 của đích.
+template <class Screen>
+bool tft_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    if (jpgTarget) {
+        int cw = Screen::clipLen(x, w, jpgTargetW), ch = Screen::clipLen(y, h, jpgTargetH);
+        for (int r = 0; r < ch; r++) {
+            memcpy(&jpgTarget[(y + r) * jpgTargetW + x], &bitmap[r * w], cw * sizeof(uint16_t));
+        }
+        return true;
+    }
+    if (!Screen::contains(x, y)) return true;
     tft.pushImage(x, y, w, h, bitmap);
     return true;
 }
 
-// Vẽ 1 frame
-void drawJPEGFrame(const VideoInfo* video, uint16_t frameIndex) {
-    uint8_t* jpg_data = (uint8_t*)pgm_read_ptr(&video->frames[frameIndex]);
-    uint16_t jpg_size = pgm_read_word(&video->frames_size[frameIndex]);
+// Vẽ 1 frame của track tại (x, y)
+void drawTrackFrame(const VideoTrack* track, uint16_t frameIndex, int16_t x, int16_t y) {
+    uint8_t* jpg_data = (uint8_t*)pgm_read_ptr(&track->frames[frameIndex]);
+    uint16_t jpg_size = pgm_read_word(&track->frames_size[frameIndex]);
 
-    if (!TJpgDec.drawJpg(0, 0, jpg_data, jpg_size)) {
+    if (!TJpgDec.drawJpg(x, y, jpg_data, jpg_size)) {
         Serial.printf("❌ Decode failed on frame %d\n", frameIndex);
     }
 }
 
-// Hàm chạy video
-void playVideos() {
-    if (NUM_VIDEOS == 0) return;
+// Vẽ 1 frame
+void drawJPEGFrame(const VideoInfo* video, uint16_t frameIndex) {
+    VideoTrack full = videoTrack(video, 0);
+    drawTrackFrame(&full, frameIndex, 0, 0);
+}
+
+// Vẽ thumbnail của clip vào ô w x h (menu preview); ô nằm ngoài Screen
+// (vd. menu đang cuộn) thì bỏ qua, không decode
+template <class Screen = VideoScreen>
+void drawVideoThumbnail(const VideoInfo* video, uint16_t frameIndex,
+                        int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    if (!Screen::clipW(x, w) || !Screen::clipH(y, h)) return;
+    TrackBudget budget = { w, h, 0, 0 };
+    VideoTrack track = selectVideoTrack(video, budget);
+    uint8_t scale = trackJpgScale(&track, w, h);
+    uint16_t f = video->num_frames ? (uint32_t)frameIndex * track.num_frames / video->num_frames : 0;
 
-    // Khởi tạo màn hình và decoder
+    TJpgDec.setJpgScale(scale);
+    drawTrackFrame(&track, f, x + (w - track.width / scale) / 2, y + (h - track.height / scale) / 2);
+    TJpgDec.setJpgScale(1);
+}
+
+// Khởi tạo màn hình và decoder
+template <class Screen>
+void initVideoDisplay() {
     tft.begin();
-    tft.setRotation(3);
-    tft.fillScreen(TFT_BLACK);
+    tft.setRotation(Screen::ROTATION);
+    // Đã có frame khởi động: vẽ lại ngay thay vì nền đen
+    if (!redrawBootFrame<Screen>(tft)) tft.fillScreen(TFT_BLACK);
 
     TJpgDec.setJpgScale(1);
     TJpgDec.setSwapBytes(true);
-    TJpgDec.setCallback(tft_output);
-
-    // Chạy từng video
-    for (uint8_t v = 0; v < NUM_VIDEOS; v++) {
-        VideoInfo* currentVideo = videoList[v];
-        for (uint16_t f = 0; f < currentVideo->num_frames; f++) {
-            drawJPEGFrame(currentVideo, f);
-            delay(30); // Delay giữa các frame
+    TJpgDec.setCallback(tft_output<Screen>);
+}
+
+// Track, vị trí và đoạn frame của 1 mục playlist
+typedef struct _ClipPlan {
+    VideoTrack track;
+    uint8_t scale;
+    int16_t x, y;
+    uint16_t w, h;
+    uint16_t in, out;
+    uint8_t loops;
+} ClipPlan;
+
+ClipPlan planClip(const PlaylistEntry* entry, const TrackBudget& budget) {
+    ClipPlan p;
+    const VideoInfo* video = entry->video;
+    p.track = selectVideoTrack(video, budget);
+    p.scale = trackJpgScale(&p.track, budget.max_w, budget.max_h);
+    p.w = p.track.width / p.scale;
+    p.h = p.track.height / p.scale;
+    p.x = (budget.max_w - p.w) / 2;
+    p.y = (budget.max_h - p.h) / 2;
+
+    // in/out tính theo frame của track đầy đủ, quy đổi sang track đã chọn
+    uint16_t n = p.track.num_frames;
+    uint16_t full = video->num_frames ? video->num_frames : 1;
+    uint16_t out = (entry->out_frame && entry->out_frame < full) ? entry->out_frame : full;
+    p.in = (uint32_t)entry->in_frame * n / full;
+    p.out = (uint32_t)out * n / full;
+    if (p.out > n) p.out = n;
+    if (p.in >= p.out) p.in = p.out ? p.out - 1 : 0;
+    p.loops = entry->loops ? entry->loops : 1;
+    return p;
+}
+
+// Decode frame đầu của clip vào buffer để chuyển clip không bị khoảng trống
+bool prepareFirstFrame(const ClipPlan& p, uint16_t* buffer) {
+    if (!buffer || p.in >= p.out) return false;
+    jpgTarget = buffer;
+    jpgTargetW = p.w;
+    jpgTargetH = p.h;
+    TJpgDec.setJpgScale(p.scale);
+    drawTrackFrame(&p.track, p.in, 0, 0);
+    jpgTarget = nullptr;
+    return true;
+}
+
+// Hàm kiểm tra dừng phát, gọi trong lúc giữ frame (vd. đổi chế độ)
+typedef bool (*VideoStopFn)();
+
+// Chạy playlist, trả về khi playlist hết (repeat = false thì chạy mãi)
+// hoặc khi stop() trả về true
+template <class Screen = VideoScreen>
+void playPlaylist(Playlist& playlist, VideoStopFn stop = nullptr) {
+    initVideoDisplay<Screen>();
+
+    // Chọn track theo màn hình và heap còn lại
+    TrackBudget budget = { Screen::WIDTH, Screen::HEIGHT, 0, 48 * 1024 };
+
+    // Buffer frame đầu của clip kế tiếp; thiếu RAM thì decode trực tiếp như cũ
+    uint16_t* nextFrame = (uint16_t*)malloc((size_t)Screen::PIXELS * sizeof(uint16_t));
+    bool nextReady = false;
+    ClipPlan nextPlan;
+    int16_t lastX = 0, lastY = 0;
+
+    const PlaylistEntry* entry;
+    bool stopped = false;
+    while (!stopped && (entry = playlist.next())) {
+        // Dùng lại plan lúc decode trước để buffer khớp track đã chọn
+        ClipPlan clip = nextReady ? nextPlan : planClip(entry, budget);
+        if (clip.in >= clip.out) continue;
+
+        // Clip nhỏ hơn clip trước thì xoá nền để không còn viền cũ
+        if (clip.x > lastX || clip.y > lastY) tft.fillScreen(TFT_BLACK);
+        lastX = clip.x;
+        lastY = clip.y;
+
+        for (uint8_t loop = 0; loop < clip.loops && !stopped; loop++) {
+            for (uint16_t f = clip.in; f < clip.out && !stopped; f++) {
+                if (nextReady) {
+                    tft.pushImage(clip.x, clip.y, clip.w, clip.h, nextFrame);
+                    nextReady = false;
+                } else {
+                    TJpgDec.setJpgScale(clip.scale);
+                    drawTrackFrame(&clip.track, f, clip.x, clip.y);
+                }
+                markFirstPixel();
+                uint32_t holdUntil = millis() + VIDEO_FRAME_DELAY_MS;
+
+                // Frame cuối: dùng thời gian giữ frame để decode trước clip sau
+                const PlaylistEntry* upcoming = playlist.peek();
+                if (upcoming && loop == clip.loops - 1 && f == clip.out - 1) {
+                    nextPlan = planClip(upcoming, budget);
+                    nextReady = prepareFirstFrame(nextPlan, nextFrame);
+                }
+                while ((int32_t)(holdUntil - millis()) > 0) delay(1);
+                if (stop && stop()) stopped = true;
+            }
         }
-        delay(300); // Delay giữa các video
     }
+
+    free(nextFrame);
+    TJpgDec.setJpgScale(1);
+}
+
+// Hàm chạy video: videoList lần lượt 1 lần (repeat = true: lặp vô hạn),
+// chuyển clip liền mạch
+template <class Screen = VideoScreen>
+void playVideos(VideoStopFn stop = nullptr, bool repeat = false) {
+    if (NUM_VIDEOS == 0) return;
+
+    PlaylistEntry entries[PLAYLIST_MAX];
+    uint8_t count = 0;
+    for (uint8_t v = 0; v < NUM_VIDEOS && count < PLAYLIST_MAX; v++) {
+        entries[count++] = { videoList[v], 0, 0, 1, 1 };
+    }
+
+    Playlist playlist(entries, count, PLAYLIST_SEQUENTIAL, repeat);
+    playPlaylist<Screen>(playlist, stop);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,37 @@
+#ifndef BENCH_MAIN_H
+#define BENCH_MAIN_H
+
+// Phần chung của các test đo thời gian (test_flappy_*): đồng hồ micro giây,
+// heap trống và điểm vào cho cả máy host (main) lẫn board (setup/loop).
+// Test định nghĩa runTests() sau khi include file này.
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+static uint32_t benchClock() { return micros(); }
+static uint32_t benchHeap() { return ESP.getFreeHeap(); }
+#else
+#include <chrono>
+static uint32_t benchClock() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+static uint32_t (*const benchHeap)() = nullptr;
+#endif
+
+static int runTests();
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000);                // chờ cổng Serial của pio test
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
+
+#endif
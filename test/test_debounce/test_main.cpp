@@ -0,0 +1,119 @@
+// Bộ chống dội với chuỗi cạnh giả lập: pio test -e native -f test_debounce
+// Mỗi chế độ: dội ở 2 đầu, xung nhiễu ngắn hơn cửa sổ, giữ nút qua thời gian khoá.
+
+#include <unity.h>
+#include "Debounce.h"
+
+static const DebounceConfig integrator = {DEBOUNCE_INTEGRATOR, 5000, 5000};
+static const DebounceConfig eager = {DEBOUNCE_EAGER, 5000, 8000};
+
+#define END_US 1000000
+
+void setUp() {}
+void tearDown() {}
+
+// ---- Integrator: cả nhấn lẫn nhả phải đứng yên đủ lâu ----
+
+void test_integrator_clean_tap() {
+    const DebounceEdge e[] = { {10000, true}, {40000, false} };
+    DebounceTraceResult r = debounceTrace(integrator, false, e, 2, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(0, r.bounces);
+    TEST_ASSERT_EQUAL_UINT32(5000, r.worstDelayUs);
+}
+
+// Dội 3 lần ở mỗi đầu: vẫn 1 nhấn 1 nhả, tính từ cạnh cuối của đợt dội
+void test_integrator_bounce_bursts() {
+    const DebounceEdge e[] = {
+        {10000, true}, {10200, false}, {10400, true}, {10600, false}, {10800, true},
+        {40000, false}, {40300, true}, {40600, false}
+    };
+    DebounceTraceResult r = debounceTrace(integrator, false, e, 8, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(3, r.bounces);
+    TEST_ASSERT_EQUAL_UINT32(5000, r.worstDelayUs);
+}
+
+// Xung ngắn hơn cửa sổ ở cả 2 chiều bị bỏ hẳn
+void test_integrator_glitch_filtered() {
+    const DebounceEdge e[] = {
+        {10000, true}, {13000, false},                  // nhiễu khi đang nhả
+        {30000, true}, {60000, false}, {61000, true},   // nhiễu khi đang giữ
+        {90000, false}
+    };
+    DebounceTraceResult r = debounceTrace(integrator, false, e, 6, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(2, r.bounces);
+}
+
+// ---- Eager: nhấn nhận ngay, nhả phải đứng yên, nhấn lại bị khoá pressUs sau nhả ----
+
+void test_eager_press_immediate() {
+    const DebounceEdge e[] = { {10000, true}, {40000, false} };
+    DebounceTraceResult r = debounceTrace(eager, false, e, 2, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(8000, r.worstDelayUs);    // trễ chỉ ở phía nhả
+
+    DebounceTraceResult p = debounceTrace(eager, false, e, 1, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, p.presses);
+    TEST_ASSERT_EQUAL_UINT32(0, p.worstDelayUs);
+}
+
+void test_eager_press_bounce_ignored() {
+    const DebounceEdge b[] = {
+        {10000, true}, {10250, false}, {10500, true}, {10750, false}, {11000, true},
+        {40000, false}, {40250, true}, {40500, false}
+    };
+    DebounceTraceResult r = debounceTrace(eager, false, b, 8, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(3, r.bounces);
+    TEST_ASSERT_EQUAL_UINT32(8000, r.worstDelayUs);    // tính từ cạnh nhả cuối
+}
+
+// Nhả chập chờn ngắn hơn releaseUs khi đang giữ: không thành nhả
+void test_eager_release_glitch_filtered() {
+    const DebounceEdge e[] = { {10000, true}, {30000, false}, {33000, true}, {60000, false} };
+    DebounceTraceResult r = debounceTrace(eager, false, e, 4, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(1, r.bounces);
+}
+
+// Nhả được nhận lúc 38000: nhấn lại lúc 40000 và giữ qua hết khoá (43000)
+// được nhận đúng lúc khoá hết; nhấn ngắn nằm gọn trong khoá bị bỏ
+void test_eager_hold_across_lockout() {
+    const DebounceEdge held[] = { {10000, true}, {30000, false}, {40000, true}, {70000, false} };
+    DebounceTraceResult r = debounceTrace(eager, false, held, 4, END_US);
+    TEST_ASSERT_EQUAL_UINT16(2, r.presses);
+    TEST_ASSERT_EQUAL_UINT16(2, r.releases);
+    TEST_ASSERT_EQUAL_UINT32(8000, r.worstDelayUs);
+
+    const DebounceEdge late[] = { {10000, true}, {30000, false}, {40000, true} };
+    DebounceTraceResult l = debounceTrace(eager, false, late, 3, 42999);
+    TEST_ASSERT_EQUAL_UINT16(1, l.presses);            // còn trong khoá
+    l = debounceTrace(eager, false, late, 3, 43000);
+    TEST_ASSERT_EQUAL_UINT16(2, l.presses);
+
+    const DebounceEdge tap[] = { {10000, true}, {30000, false}, {40000, true}, {41000, false} };
+    DebounceTraceResult t = debounceTrace(eager, false, tap, 4, END_US);
+    TEST_ASSERT_EQUAL_UINT16(1, t.presses);
+    TEST_ASSERT_EQUAL_UINT16(1, t.releases);
+    TEST_ASSERT_EQUAL_UINT32(1, t.bounces);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_integrator_clean_tap);
+    RUN_TEST(test_integrator_bounce_bursts);
+    RUN_TEST(test_integrator_glitch_filtered);
+    RUN_TEST(test_eager_press_immediate);
+    RUN_TEST(test_eager_press_bounce_ignored);
+    RUN_TEST(test_eager_release_glitch_filtered);
+    RUN_TEST(test_eager_hold_across_lockout);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+// Thông lượng logic FlappyBird (flappyBench) và replay đúng từng tick.
+//   Máy host: pio test -e native -f test_flappy_bench
+//   Trên board: pio test -e esp32_c3 -f test_flappy_bench
+
+#include <unity.h>
+#include <stdio.h>
+#include "FlappyBench.h"
+#include "../BenchMain.h"
+
+// Sân chơi giống FlappyBird trong main.cpp (ngang 160x80)
+typedef PanelView<BoardPanel, 3> BenchScreen;
+
+#define BENCH_TICKS 200000
+#define REALTIME_TPS 50         // 1 tick = FLAPPY_TICK_MS 20 ms
+
+void setUp() {}
+void tearDown() {}
+
+static void report(const char* name, const FlappyBenchResult& r) {
+    char line[128];
+    snprintf(line, sizeof(line), "%s: %lu tick/s, %lu van, best %d, heap %ld B", name,
+             (unsigned long)r.ticksPerSecond(), (unsigned long)r.runs, r.bestScore, (long)r.heapDelta);
+    TEST_MESSAGE(line);
+}
+
+void test_bench_throughput() {
+    FlappyBenchResult rnd = flappyBench<BenchScreen>(BENCH_TICKS, FLAPPY_DRIVER_RANDOM, 1, benchClock, benchHeap);
+    FlappyBenchResult bot = flappyBench<BenchScreen>(BENCH_TICKS, FLAPPY_DRIVER_AUTO, 1, benchClock, benchHeap);
+    report("random", rnd);
+    report("auto", bot);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCH_TICKS, rnd.ticks);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_TICKS, bot.ticks);
+    // Logic không cấp phát, và phải nhanh hơn thời gian thực rất nhiều
+    TEST_ASSERT_INT32_WITHIN(64, 0, bot.heapDelta);     // trên board: chừa cho task nền
+    TEST_ASSERT_TRUE(bot.ticksPerSecond() > 100 * REALTIME_TPS);
+    // Bot bám khe sống lâu hơn nhấn ngẫu nhiên
+    TEST_ASSERT_TRUE(bot.runs < rnd.runs);
+    TEST_ASSERT_TRUE(bot.bestScore > rnd.bestScore);
+}
+
+void test_bench_deterministic() {
+    FlappyBenchResult a = flappyBench<BenchScreen>(20000, FLAPPY_DRIVER_AUTO, 7, benchClock);
+    FlappyBenchResult b = flappyBench<BenchScreen>(20000, FLAPPY_DRIVER_AUTO, 7, benchClock);
+    TEST_ASSERT_EQUAL_UINT32(a.runs, b.runs);
+    TEST_ASSERT_EQUAL_INT(a.bestScore, b.bestScore);
+}
+
+// Cùng bot, cùng seed: độ khó dọc và ngang phải tương đương (số tick sống
+// trung bình mỗi ván chênh không quá 2 lần)
+void test_orientations_comparable() {
+    typedef PanelView<BoardPanel, 0> PortraitScreen;
+    FlappyBenchResult p = flappyBench<PortraitScreen>(BENCH_TICKS, FLAPPY_DRIVER_AUTO, 1, benchClock);
+    FlappyBenchResult l = flappyBench<BenchScreen>(BENCH_TICKS, FLAPPY_DRIVER_AUTO, 1, benchClock);
+    uint32_t pAvg = p.ticks / p.runs, lAvg = l.ticks / l.runs;
+
+    char line[96];
+    snprintf(line, sizeof(line), "doc: %lu tick/van, best %d; ngang: %lu tick/van, best %d",
+             (unsigned long)pAvg, p.bestScore, (unsigned long)lAvg, l.bestScore);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(lAvg * 2 >= pAvg && pAvg * 2 >= lAvg);
+    TEST_ASSERT_TRUE(l.bestScore * 2 >= p.bestScore && p.bestScore * 2 >= l.bestScore);
+}
+
+// 1 ván do bot chơi, ghi nhật ký như FlappyBird, replay phải ra đúng tick và điểm
+void test_replay_matches_live_game() {
+    static FlappySim<BenchScreen> live, replay;
+    static FlappyInputLog<512> log;
+    const uint32_t seed = 12345;
+    live.reset(seed);
+    log.clear();
+    while (!live.gameOver && live.tick < 100000) {
+        bool flap = flappyAutoPilot(live);
+        log.record(live.tick, flap);
+        live.step(flap);
+    }
+    TEST_ASSERT_FALSE(log.overflowed());
+
+    FlappyReplayResult r = flappyReplay(replay, seed, log.data(), log.count(), 100000);
+    TEST_ASSERT_EQUAL_UINT32(live.tick, r.ticks);
+    TEST_ASSERT_EQUAL_INT(live.score, r.score);
+    TEST_ASSERT_EQUAL(live.gameOver, r.gameOver);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_throughput);
+    RUN_TEST(test_bench_deterministic);
+    RUN_TEST(test_orientations_comparable);
+    RUN_TEST(test_replay_matches_live_game);
+    return UNITY_END();
+}
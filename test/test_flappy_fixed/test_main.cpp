@@ -0,0 +1,89 @@
+// FlappySim với vật lý Q24.8 so với chính lớp đó dùng float như trước
+// user-031: cùng quỹ đạo trong 1 px và thời gian chạy của mỗi cách.
+//   Máy host: pio test -e native -f test_flappy_fixed (có FPU: chỉ để so)
+//   ESP32-C3: pio test -e esp32_c3 -f test_flappy_fixed (float giả lập bằng
+//   phần mềm: fixed-point phải nhanh hơn)
+
+#include <unity.h>
+#include <stdio.h>
+#include "FlappySim.h"
+#include "../BenchMain.h"
+
+// RV32 không có extension F: float là lời gọi thư viện soft-float
+#if defined(__riscv) && !defined(__riscv_flen)
+#define SOFT_FLOAT 1
+#else
+#define SOFT_FLOAT 0
+#endif
+
+// Sân chơi giống FlappyBird trong main.cpp (ngang 160x80)
+typedef PanelView<BoardPanel, 3> BenchScreen;
+typedef FlappySim<BenchScreen, FlappyFixedPhysics> FixedSim;
+typedef FlappySim<BenchScreen, FlappyFloatPhysics> FloatSim;
+
+#define SIMS 8
+#define TICKS 20000
+
+void setUp() {}
+void tearDown() {}
+
+// Số micro giây cho SIMS x TICKS lần step(), nhấn theo cùng 1 dãy PRNG
+template <class Sim>
+static uint32_t runSims(int32_t& checksum) {
+    static Sim sims[SIMS];
+    for (uint8_t s = 0; s < SIMS; s++) sims[s].reset(s + 1);
+    FlappyRng rng;
+    rng.seed(99);
+    int32_t sum = 0;
+    uint32_t start = benchClock();
+    for (uint32_t t = 0; t < TICKS; t++) {
+        uint32_t flaps = rng.next();
+        for (uint8_t s = 0; s < SIMS; s++) {
+            Sim& sim = sims[s];
+            sim.step((flaps >> (s * 3) & 0x7) == 0);    // ~1/8 tick vỗ
+            if (sim.gameOver) sim.reset(s + 1);
+            sum += sim.birdY + sim.score;
+        }
+    }
+    uint32_t us = benchClock() - start;
+    checksum = sum;
+    return us;
+}
+
+void test_same_arc_within_one_pixel() {
+    static FixedSim fx;
+    static FloatSim fl;
+    fx.reset(1);
+    fl.reset(1);
+    // 1 cú vỗ rồi rơi tự do 25 tick (khoảng cách thường gặp giữa 2 lần nhấn).
+    // Trọng lực làm tròn xuống trong Q24.8: lệch vị trí cộng dồn ~t^2/2 lần sai số
+    for (int t = 0; t < 25; t++) {
+        fx.step(t == 0);
+        fl.step(t == 0);
+        TEST_ASSERT_FALSE(fx.gameOver || fl.gameOver);
+        TEST_ASSERT_INT_WITHIN(1, fl.birdY, fx.birdY);
+    }
+}
+
+void test_fixed_vs_float_speed() {
+    int32_t sumFixed = 0, sumFloat = 0;
+    uint32_t usFixed = runSims<FixedSim>(sumFixed);
+    uint32_t usFloat = runSims<FloatSim>(sumFloat);
+
+    char line[128];
+    snprintf(line, sizeof(line), "%lu step: fixed %lu us, float %lu us (x%.2f)%s",
+             (unsigned long)SIMS * TICKS, (unsigned long)usFixed, (unsigned long)usFloat,
+             usFixed ? (double)usFloat / usFixed : 0.0, SOFT_FLOAT ? ", soft-float" : "");
+    TEST_MESSAGE(line);
+    TEST_ASSERT_TRUE(sumFixed != 0 && sumFloat != 0);
+#if SOFT_FLOAT
+    TEST_ASSERT_TRUE(usFixed < usFloat);
+#endif
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_same_arc_within_one_pixel);
+    RUN_TEST(test_fixed_vs_float_speed);
+    return UNITY_END();
+}
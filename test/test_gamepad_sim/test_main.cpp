@@ -0,0 +1,164 @@
+// Giả lập tay cầm trên máy host: pio test -e native -f test_gamepad_sim
+// Kịch bản cạnh GPIO -> InputService + GamepadCore -> GamepadRecorder,
+// kiểm tra số report, thứ tự nhấn/nhả và độ trễ tới lúc report giao đi.
+
+#include <unity.h>
+#include "GamepadSim.h"
+
+#define WAKE_US 50              // ngắt -> loop chạy
+#define IDLE_US 100000          // IDLE_WAIT_MS
+#define END_US 3000000
+
+static const DebounceConfig eager = {DEBOUNCE_EAGER, 5000, 8000};
+
+static GamepadSimConfig irqConfig(uint8_t buttons, const DebounceConfig& d) {
+    GamepadSimConfig cfg = {buttons, d, 0, WAKE_US, IDLE_US};
+    return cfg;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Report liên tiếp phải khác nhau, mỗi nút đổi nhấn/nhả xen kẽ và cuối cùng nhả hết
+template <uint16_t N>
+static void assertAlternating(const GamepadRecorder<N>& rec) {
+    uint64_t prev = 0;
+    for (uint16_t i = 0; i < rec.count(); i++) {
+        uint64_t now = rec.data()[i].buttons;
+        TEST_ASSERT_TRUE_MESSAGE(now != prev, "report trùng trạng thái trước");
+        prev = now;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)prev);
+}
+
+// Tối đa 1 report mỗi sự kiện kết nối BLE
+template <uint16_t N>
+static void assertOnePerEvent(const GamepadRecorder<N>& rec) {
+    for (uint16_t i = 1; i < rec.count(); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(rec.data()[i].airUs > rec.data()[i - 1].airUs, "2 report trong 1 sự kiện kết nối");
+    }
+}
+
+void test_clean_tap() {
+    GpioTrace<8> tr;
+    tr.tap(0, 10000, 30000);
+    GamepadRecorder<8> rec;
+    GamepadSimResult r = gamepadSimulate(irqConfig(1, eager), tr.data(), tr.count(), END_US, rec);
+
+    TEST_ASSERT_EQUAL_UINT32(2, r.reports);
+    TEST_ASSERT_EQUAL_UINT16(2, rec.count());
+    TEST_ASSERT_EQUAL_UINT32(1, (uint32_t)rec.data()[0].buttons);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)rec.data()[1].buttons);
+
+    // Eager: nhấn giao đi ngay sau khi loop thức; nhả chờ đủ releaseUs
+    TEST_ASSERT_EQUAL_UINT32(10000 + WAKE_US + rec.stackUs, rec.data()[0].sentUs);
+    TEST_ASSERT_TRUE(rec.data()[1].sentUs >= 40000 + eager.releaseUs);
+    TEST_ASSERT_TRUE(rec.data()[1].sentUs <= 40000 + eager.releaseUs + 1000 + WAKE_US + rec.stackUs);
+    TEST_ASSERT_EQUAL_UINT32(2, r.toStack.count());
+    assertOnePerEvent(rec);
+}
+
+void test_bounce_does_not_add_reports() {
+    GpioTrace<64> tr;
+    for (uint8_t k = 0; k < 4; k++) tr.tap(0, 10000 + k * 60000, 30000, 3, 250);
+    GamepadRecorder<16> rec;
+    GamepadSimResult r = gamepadSimulate(irqConfig(1, eager), tr.data(), tr.count(), END_US, rec);
+
+    TEST_ASSERT_EQUAL_UINT32(8, r.reports);
+    TEST_ASSERT_TRUE(r.bounces > 0);
+    assertAlternating(rec);
+    assertOnePerEvent(rec);
+}
+
+void test_simultaneous_press_one_report() {
+    GpioTrace<8> tr;
+    tr.tap(0, 10000, 30000);
+    tr.tap(1, 10000, 30000);
+    GamepadRecorder<8> rec;
+    GamepadSimResult r = gamepadSimulate(irqConfig(2, eager), tr.data(), tr.count(), END_US, rec);
+
+    TEST_ASSERT_EQUAL_UINT32(2, r.reports);
+    TEST_ASSERT_EQUAL_UINT32(4, r.changes);
+    TEST_ASSERT_EQUAL_UINT32(3, (uint32_t)rec.data()[0].buttons);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)rec.data()[1].buttons);
+    assertOnePerEvent(rec);
+}
+
+// Tổ hợp 3 nút nhấn/nhả lệch nhau 1 ms: các thay đổi trong 1 khoảng kết nối
+// gom vào 1 report thay vì mỗi cạnh 1 report
+void test_rolled_chord_one_report_per_event() {
+    GpioTrace<128> tr;
+    for (int k = 0; k < 20; k++) {
+        uint32_t t = 10000 + k * 100000;
+        for (uint8_t b = 0; b < 3; b++) tr.tap(b, t + b * 1000, 40000);
+    }
+    GamepadRecorder<128> rec;
+    GamepadSimResult r = gamepadSimulate(irqConfig(3, eager), tr.data(), tr.count(), END_US, rec);
+
+    TEST_ASSERT_FALSE(rec.overflowed());
+    TEST_ASSERT_EQUAL_UINT32(120, r.changes);
+    TEST_ASSERT_TRUE(r.reports <= 80);                      // nút đầu gửi ngay, 2 nút sau gom chung
+    assertAlternating(rec);
+    assertOnePerEvent(rec);
+    // Thay đổi bị gom chờ tối đa 1 khoảng kết nối (+ làm tròn ms của lượt chờ)
+    TEST_ASSERT_TRUE(r.toStack.worst() <= eager.releaseUs + rec.connIntervalUs + 1000 + WAKE_US + rec.stackUs);
+}
+
+// Nhấn-nhả gọn trong 1 chu kỳ quét: host vẫn phải thấy đủ nhấn rồi nhả
+void test_tap_inside_one_poll() {
+    DebounceConfig fast = {DEBOUNCE_EAGER, 5000, 1000};
+    GamepadSimConfig cfg = {1, fast, 5000, WAKE_US, IDLE_US};
+    GpioTrace<8> tr;
+    tr.tap(0, 10001, 500);
+    GamepadRecorder<8> rec;
+    GamepadSimResult r = gamepadSimulate(cfg, tr.data(), tr.count(), END_US, rec);
+
+    TEST_ASSERT_EQUAL_UINT32(2, r.reports);
+    TEST_ASSERT_EQUAL_UINT32(1, (uint32_t)rec.data()[0].buttons);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)rec.data()[1].buttons);
+    // Nhả cùng lượt quét với nhấn nhưng đi ở sự kiện kết nối kế tiếp
+    TEST_ASSERT_TRUE(rec.data()[1].sentUs - rec.data()[0].sentUs >= rec.connIntervalUs);
+    assertOnePerEvent(rec);
+}
+
+// Kịch bản hỗn hợp 3 nút có dội: ngắt phải nhanh hơn quét 5 ms, không mất report
+void test_interrupts_beat_polling() {
+    GpioTrace<512> tr;
+    for (int k = 0; k < 40; k++) {
+        uint32_t t = 10000 + k * 60000 + k * 1237 % 5000;      // lệch pha với nhịp quét
+        tr.tap(k % 3, t, 30000, k % 4, 250);
+        if (k % 5 == 0) tr.tap((k + 1) % 3, t, 20000, 1, 300);
+    }
+
+    GamepadRecorder<256> irqRec, pollRec;
+    GamepadSimConfig poll = {3, eager, 5000, WAKE_US, IDLE_US};
+    GamepadSimResult irq = gamepadSimulate(irqConfig(3, eager), tr.data(), tr.count(), END_US, irqRec);
+    GamepadSimResult polled = gamepadSimulate(poll, tr.data(), tr.count(), END_US, pollRec);
+
+    TEST_ASSERT_FALSE(irqRec.overflowed());
+    TEST_ASSERT_EQUAL_UINT32(irq.changes, polled.changes);
+    TEST_ASSERT_EQUAL_UINT32(96, irq.changes);              // 48 lần nhấn, mỗi lần nhấn + nhả
+    TEST_ASSERT_TRUE(irq.reports < irq.changes);           // tap 2 nút cùng lúc gom chung
+    assertAlternating(irqRec);
+    assertAlternating(pollRec);
+    assertOnePerEvent(irqRec);
+    assertOnePerEvent(pollRec);
+
+    // Nhấn eager: median = thức + stack; p99 giới hạn bởi nhả (releaseUs + làm tròn ms)
+    TEST_ASSERT_TRUE(irq.toStack.median() <= 2 * (WAKE_US + irqRec.stackUs));
+    TEST_ASSERT_TRUE(irq.toStack.worst() <= eager.releaseUs + 1000 + WAKE_US + irqRec.stackUs);
+    TEST_ASSERT_TRUE(irq.toStack.median() < polled.toStack.median());
+    TEST_ASSERT_TRUE(irq.toStack.percentile(99) < polled.toStack.percentile(99));
+    TEST_ASSERT_TRUE(irq.wakeups < polled.wakeups);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_tap);
+    RUN_TEST(test_bounce_does_not_add_reports);
+    RUN_TEST(test_simultaneous_press_one_report);
+    RUN_TEST(test_rolled_chord_one_report_per_event);
+    RUN_TEST(test_tap_inside_one_poll);
+    RUN_TEST(test_interrupts_beat_polling);
+    return UNITY_END();
+}